@@ -2,8 +2,11 @@
 #include <Wire.h>
 #include <bluefruit.h>
 
+#include <atomic>
+
 #include "src/system/alerts.h"
 #include "src/system/behavior.h"
+#include "src/system/charge_idle.h"
 #include "src/system/charger/charger.h"
 #include "src/system/physical/IMU.h"
 #include "src/system/physical/MicroPhone.h"
@@ -11,8 +14,13 @@
 #include "src/system/physical/bluetooth.h"
 #include "src/system/physical/button.h"
 #include "src/system/physical/fileSystem.h"
+#include "src/system/physical/i2c.h"
 #include "src/system/physical/led_power.h"
+#include "src/system/scheduler.h"
+#include "src/system/thermal.h"
+#include "src/system/utils/profiler.h"
 #include "src/system/utils/serial.h"
+#include "src/system/utils/tracer.h"
 #include "src/system/utils/utils.h"
 #include "src/user_functions.h"
 
@@ -43,6 +51,15 @@ void setup() {
     }
   }
 
+  // loop stages execution time
+  profiler::setup();
+
+  // the thread deadlines, before the interrupts that wake them up
+  scheduler::setup();
+
+  // shared i2c bus, before any i2c communication
+  i2c::setup();
+
   // set watchdog (reset the soft when the program crashes)
   // Should be long enough to flash the microcontroler !!!
   set_watchdog(5);  // second timeout
@@ -55,8 +72,8 @@ void setup() {
   // setup serial
   serial::setup();
 
-  analogReference(AR_INTERNAL_3_0);  // 3v reference
-  analogReadResolution(ADC_RES_EXP);
+  // background battery voltage sampling
+  battery::setup();
 
   // setup charger
   charger::setup();
@@ -89,6 +106,9 @@ void setup() {
   }
   // else: start in shutdown mode
 
+  // input, power and sensors threads
+  start_threads();
+
   // user requested another thread, spawn it
   if (user::should_spawn_thread()) {
     Scheduler.startLoop(secondary_thread);
@@ -103,23 +123,22 @@ void secondary_thread() {
 
 void check_loop_runtime(const uint32_t runTime) {
   static constexpr uint8_t maxAlerts = 5;
-  static uint32_t alarmRaisedTime = 0;
   // check the loop duration
   static uint8_t isOnSlowLoopCount = 0;
   if (runTime > LOOP_UPDATE_PERIOD + 1) {
+    tracer::trace(tracer::Event::LOOP_OVERRUN, runTime);
     isOnSlowLoopCount = min(isOnSlowLoopCount + 1, maxAlerts);
   } else if (isOnSlowLoopCount > 0) {
     isOnSlowLoopCount--;
   }
 
   if (isOnSlowLoopCount >= maxAlerts) {
-    alarmRaisedTime = millis();
     AlertManager.raise_alert(Alerts::LONG_LOOP_UPDATE);
   }
-  // lower the alert (after 5 seconds)
-  else if (isOnSlowLoopCount <= 1 and millis() - alarmRaisedTime > 3000) {
+  // lower the alert (stays displayed for its clear delay)
+  else if (isOnSlowLoopCount <= 1) {
     AlertManager.clear_alert(Alerts::LONG_LOOP_UPDATE);
-  };
+  }
 }
 
 void cpuTemperarureAlerts() {
@@ -146,54 +165,303 @@ void batteryAlerts() {
   }
 }
 
-void loop() {
-  uint32_t start = millis();
+// update periods of the slow tasks (ms)
+constexpr uint32_t temperatureUpdatePeriod = 500;
+constexpr uint32_t batteryUpdatePeriod = 100;
+constexpr uint32_t sensorsUpdatePeriod = 1000;
+
+// stack of the secondary threads (words)
+constexpr uint32_t threadStackSize = 1024;
+
+// threads that must run for the watchdog to be reloaded
+constexpr uint8_t animationThread = 0;
+constexpr uint8_t inputThread = 1;
+constexpr uint8_t powerThread = 2;
+constexpr uint8_t sensorsThread = 3;
+constexpr uint8_t threadCount = 4;
+constexpr uint8_t allThreadsAlive = (1 << threadCount) - 1;
+// one bit by thread that ran since the last reload
+static std::atomic<uint8_t> aliveThreads(0);
+
+// secondary threads that claimed their scheduler tasks
+constexpr uint8_t secondaryThreadCount = 3;
+static std::atomic<uint8_t> registeredThreadCount(0);
+
+// reload the watchdog when all the threads ran since the last reload
+void feed_watchdog(const uint8_t thread) {
+  const uint8_t alive = aliveThreads.fetch_or(1 << thread) | (1 << thread);
+  if (alive != allThreadsAlive) return;
+
+  // only one thread wins the reset, and reloads
+  uint8_t expected = allThreadsAlive;
+  if (!aliveThreads.compare_exchange_strong(expected, 0)) return;
 
   // update watchdog (prevent crash)
   NRF_WDT->RR[0] = WDT_RR_RR_Reload;
+}
+
+// button actions, from the input thread to the animation thread
+struct ButtonEvent {
+  uint8_t clicks;
+  uint32_t holdDuration;  // 0 when a hold is released
+  bool isHold;
+};
+constexpr uint8_t buttonEventQueueLength = 16;
+static QueueHandle_t buttonEvents = nullptr;
+
+void post_button_event(const ButtonEvent& event) {
+  // never block the input thread, a full queue drops the event
+  if (xQueueSend(buttonEvents, &event, 0) == pdTRUE) {
+    scheduler::wake(scheduler::Task::DISPLAY);
+  }
+}
+
+void start_threads() {
+  buttonEvents = xQueueCreate(buttonEventQueueLength, sizeof(ButtonEvent));
+  setup_alert_display();
+
+  // setup runs in the loop thread, the animation thread. It also powers the
+  // sensors down: the user loop uses them
+  scheduler::set_thread(scheduler::Task::DISPLAY);
+  scheduler::set_thread(scheduler::Task::USER);
+  scheduler::set_thread(scheduler::Task::MICROPHONE);
+  scheduler::set_thread(scheduler::Task::IMU);
+
+  Scheduler.startLoop(input_thread, "input", threadStackSize,
+                      TASK_PRIO_NORMAL);
+  Scheduler.startLoop(power_thread, "power", threadStackSize, TASK_PRIO_LOW);
+  Scheduler.startLoop(sensors_thread, "sensors", threadStackSize,
+                      TASK_PRIO_LOWEST);
+}
+
+// button reading and serial commands
+void input_thread() {
+  using profiler::ScopedTimer;
+  using profiler::Stage;
+  using scheduler::Task;
+
+  static bool isStarted = false;
+  if (!isStarted) {
+    scheduler::set_thread(Task::BUTTON);
+    registeredThreadCount.fetch_add(1);
+    isStarted = true;
+  }
+
+  const uint32_t start = millis();
+  feed_watchdog(inputThread);
+
+  if (scheduler::is_due(Task::BUTTON, start)) {
+    scheduler::set_deadline(
+        Task::BUTTON, start + charge_idle::get_period(LOOP_UPDATE_PERIOD));
+
+    {
+      ScopedTimer timer(Stage::SERIAL_CLI);
+      // handle user serial events
+      serial::handleSerialEvents();
+    }
+
+    // the actions run in the animation thread
+    ScopedTimer timer(Stage::BUTTON);
+    button::handle_events(
+        [](const uint8_t clicks) { post_button_event({clicks, 0, false}); },
+        [](const uint8_t clicks, const uint32_t holdDuration) {
+          post_button_event({clicks, holdDuration, true});
+        });
+
+    // a button action leaves the charge idle state
+    static uint32_t lastButtonEventTime = 0;
+    if (button::get_last_event_time() != lastButtonEventTime) {
+      lastButtonEventTime = button::get_last_event_time();
+      charge_idle::notify_activity();
+    }
+  }
+
+  scheduler::sleep_until_next_deadline();
+}
+
+// alerts, charger and battery
+void power_thread() {
+  using profiler::ScopedTimer;
+  using profiler::Stage;
+  using scheduler::Task;
+
+  static bool isStarted = false;
+  if (!isStarted) {
+    scheduler::set_thread(Task::ALERTS);
+    scheduler::set_thread(Task::BATTERY);
+    registeredThreadCount.fetch_add(1);
+    isStarted = true;
+  }
+
+  const uint32_t start = millis();
+  feed_watchdog(powerThread);
+
+  const bool isShutdown = is_shutdown();
+  scheduler::set_enabled(Task::BATTERY, !isShutdown);
+
+  if (scheduler::is_due(Task::BATTERY, start)) {
+    scheduler::set_deadline(Task::BATTERY, start + batteryUpdatePeriod);
+
+    ScopedTimer timer(Stage::BATTERY);
+    batteryAlerts();
+    // keep the system under its power budget
+    ledpower::update_current_limiter();
+  }
 
-  // loop is not ran in shutdown mode
-  button::handle_events(button_clicked_callback, button_hold_callback);
-  // handle user serial events
-  serial::handleSerialEvents();
+  if (scheduler::is_due(Task::ALERTS, start)) {
+    scheduler::set_deadline(
+        Task::ALERTS, start + charge_idle::get_period(LOOP_UPDATE_PERIOD));
 
-  if (is_shutdown()) {
+    ScopedTimer timer(Stage::ALERTS);
     // display alerts if needed
     handle_alerts();
 
-    // charger unplugged, real shutdown
-    if (!charger::is_usb_powered()) {
-      shutdown();
+    // charger unplugged, real shutdown (run by the animation thread)
+    if (isShutdown and !charger::is_usb_powered()) {
+      request_shutdown();
     }
 
-    delay(LOOP_UPDATE_PERIOD);
-    return;
+    // battery state of charge, also while charging
+    battery::update_state_of_charge(isShutdown);
+
+    // slow down the updates when shut down and charging
+    charge_idle::update(isShutdown);
+    battery::set_sample_period(
+        charge_idle::get_period(battery::samplePeriod_ms));
+  }
+
+  scheduler::sleep_until_next_deadline();
+}
+
+// temperatures
+void sensors_thread() {
+  using profiler::ScopedTimer;
+  using profiler::Stage;
+  using scheduler::Task;
+
+  static bool isStarted = false;
+  if (!isStarted) {
+    scheduler::set_thread(Task::TEMPERATURE);
+    registeredThreadCount.fetch_add(1);
+    isStarted = true;
+  }
+
+  const uint32_t start = millis();
+  feed_watchdog(sensorsThread);
+
+  // sensors are not used in shutdown mode
+  scheduler::set_enabled(Task::TEMPERATURE, !is_shutdown());
+
+  if (scheduler::is_due(Task::TEMPERATURE, start)) {
+    scheduler::set_deadline(Task::TEMPERATURE,
+                            start + temperatureUpdatePeriod);
+
+    ScopedTimer timer(Stage::TEMPERATURE);
+    // derate the brightness when the system heats up
+    thermal::update();
+    cpuTemperarureAlerts();
+  }
+
+  scheduler::sleep_until_next_deadline();
+}
+
+// animation thread: button actions, button colors and user loop
+void loop() {
+  using profiler::ScopedTimer;
+  using profiler::Stage;
+  using scheduler::Task;
+
+  // the loop must never wait for the other threads, but a higher priority
+  // before they run would starve them
+  static bool isPriorityRaised = false;
+  if (!isPriorityRaised and
+      registeredThreadCount.load() == secondaryThreadCount) {
+    vTaskPrioritySet(NULL, TASK_PRIO_HIGH);
+    isPriorityRaised = true;
   }
 
-  // user loop call
-  user::loop();
+  const uint32_t start = millis();
+  feed_watchdog(animationThread);
+
+  // loop and sensors are not ran in shutdown mode
+  const bool isShutdown = is_shutdown();
+  scheduler::set_enabled(Task::USER, !isShutdown);
+  scheduler::set_enabled(Task::MICROPHONE, !isShutdown);
+  scheduler::set_enabled(Task::IMU, !isShutdown);
+
+  if (scheduler::is_due(Task::DISPLAY, start)) {
+    const uint32_t displayPeriod = charge_idle::get_period(LOOP_UPDATE_PERIOD);
+    scheduler::set_deadline(Task::DISPLAY, start + displayPeriod);
+
+    ScopedTimer timer(Stage::DISPLAY);
+    ButtonEvent event;
+    while (xQueueReceive(buttonEvents, &event, 0) == pdTRUE) {
+      if (event.isHold) {
+        button_hold_callback(event.clicks, event.holdDuration);
+      } else {
+        button_clicked_callback(event.clicks);
+      }
+    }
+
+    // alert or battery level pattern, posted by the power thread
+    update_alert_display();
+
+    // next frame of the button color (dithered at the fast periods)
+    button::update(displayPeriod);
+
+    // brightness limit of the alerts, posted by the power thread
+    update_brightness_limit();
 
-  cpuTemperarureAlerts();
-  batteryAlerts();
+    // shutdown requested by the power thread
+    update_shutdown_request();
+  }
+
+  // start of the last user frame (cycles), 0 in shutdown mode
+  static uint32_t lastFrameTicks = 0;
+  if (isShutdown) lastFrameTicks = 0;
+
+  if (scheduler::is_due(Task::USER, start)) {
+    scheduler::set_deadline(Task::USER, start + LOOP_UPDATE_PERIOD);
+
+    // frame period: the lateness of the frames shows in the max and p99
+    const uint32_t frameTicks = profiler::get_ticks();
+    if (lastFrameTicks != 0) {
+      profiler::add_sample(Stage::FRAME, frameTicks - lastFrameTicks);
+    }
+    lastFrameTicks = frameTicks;
+
+    {
+      ScopedTimer timer(Stage::USER);
+      // brightness hold ramp, then user loop call
+      update_brightness_ramp();
+      user::loop();
+    }
 
 #ifdef USE_BLUETOOTH
-  bluetooth::parse_messages();
+    ScopedTimer timer(Stage::BLUETOOTH);
+    bluetooth::parse_messages();
 #endif
-
-  // wait for a delay if we are faster than the set refresh rate
-  uint32_t stop = millis();
-  const uint32_t loopDuration = (stop - start);
-  if (loopDuration < LOOP_UPDATE_PERIOD) {
-    delay(LOOP_UPDATE_PERIOD - loopDuration);
   }
 
-  stop = millis();
-  check_loop_runtime(stop - start);
+  // automatically deactivate sensors if they are not used for a time, in the
+  // thread that uses them
+  if (scheduler::is_due(Task::MICROPHONE, start)) {
+    scheduler::set_deadline(Task::MICROPHONE, start + sensorsUpdatePeriod);
+    ScopedTimer timer(Stage::SENSORS);
+    microphone::disable_after_non_use();
+  }
+  if (scheduler::is_due(Task::IMU, start)) {
+    scheduler::set_deadline(Task::IMU, start + sensorsUpdatePeriod);
+    ScopedTimer timer(Stage::SENSORS);
+    // die temperature for the thermal controller, then power management
+    imu::update_temperature();
+    imu::disable_after_non_use();
+  }
 
-  // display alerts if needed
-  handle_alerts();
+  if (!isShutdown) {
+    check_loop_runtime(millis() - start);
+  }
 
-  // automatically deactivate sensors if they are not used for a time
-  microphone::disable_after_non_use();
-  imu::disable_after_non_use();
+  // sleep until the next deadline, or until an interrupt
+  scheduler::sleep_until_next_deadline();
 }
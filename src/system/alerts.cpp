@@ -1,4 +1,117 @@
 #include "alerts.h"
 
+#include <Arduino.h>
+
 // resolve a bug with the static variable resetting randomly
-Alert AlertManager;
\ No newline at end of file
+Alert AlertManager;
+
+static constexpr uint8_t noBrightnessCap = 255;
+static constexpr uint8_t quarterBrightness = 0.25 * noBrightnessCap;
+
+// alert behaviors, indexed by alert bit
+static constexpr AlertDescriptor descriptors[alertCount] = {
+    // TEMP_CRITICAL: shutdown immediatly
+    {"temperature critical", 0, Indicator::BLINK, 0xFF8C00, 100, 100,
+     noBrightnessCap, 0, 0, 0, false},
+    // BATTERY_CRITICAL: fast red blink, then shutdown after 2 seconds
+    {"battery critical", 1, Indicator::BLINK, 0xFF0000, 100, 100,
+     noBrightnessCap, 0, 0, 2000, false},
+    // MAIN_LOOP_FREEZE: no specific behavior, white blink
+    {"main loop freeze", 2, Indicator::BLINK, 0xFFFFFF, 300, 300,
+     noBrightnessCap, 0, 0, noShutdown, false},
+    // BATTERY_READINGS_INCOHERENT: fast green blink
+    {"battery readings incoherent", 3, Indicator::BLINK, 0x00FF00, 100, 100,
+     noBrightnessCap, 0, 0, noShutdown, false},
+    // TEMP_TOO_HIGH: orange blink, the thermal controller derates the output
+    {"temperature too high", 4, Indicator::BLINK, 0xFF8C00, 300, 300,
+     noBrightnessCap, 0, 0, noShutdown, false},
+    // BATTERY_LOW: red blink, save some battery
+    {"battery low", 5, Indicator::BLINK, 0xFF0000, 300, 300, quarterBrightness,
+     0, 0, noShutdown, true},
+    // LONG_LOOP_UPDATE: fushia blink, displayed for at least 3 seconds
+    {"long loop update", 6, Indicator::BLINK, 0xFF00FF, 400, 400,
+     noBrightnessCap, 0, 3000, noShutdown, false},
+    // BLUETOOTH_ADVERT: blue breeze
+    {"bluetooth advertising", 7, Indicator::BREEZE, 0x0000FF, 1000, 500,
+     noBrightnessCap, 0, 0, noShutdown, false},
+};
+
+// get_highest_index displays the lowest active bit: the bits must be sorted
+// by priority, a new alert goes at the bit of its priority
+static constexpr bool is_sorted_by_priority() {
+  for (uint8_t i = 1; i < alertCount; ++i) {
+    if (descriptors[i].priority <= descriptors[i - 1].priority) return false;
+  }
+  return true;
+}
+static_assert(is_sorted_by_priority(),
+              "the alert bits must follow the descriptor priorities");
+static_assert(Alerts::BLUETOOTH_ADVERT == 1 << (alertCount - 1),
+              "alertCount must match the last alert bit");
+
+const AlertDescriptor& get_alert_descriptor(const uint8_t index) {
+  return descriptors[index];
+}
+
+void Alert::raise_alert(const Alerts alert) {
+  if (alert == Alerts::NONE) return;
+  // cheap early exit, the fetch or below settles the races
+  if ((_requested.load(std::memory_order_relaxed) & alert) != 0x0) return;
+
+  const uint8_t index = __builtin_ctz(alert);
+  _raiseTime[index].store(millis(), std::memory_order_relaxed);
+  const uint32_t previous =
+      _requested.fetch_or(alert, std::memory_order_acq_rel);
+  if ((previous & alert) != 0x0) return;
+
+  _sequence.fetch_add(1, std::memory_order_release);
+  tracer::trace(tracer::Event::ALERT_RAISED, alert);
+}
+
+void Alert::clear_alert(const Alerts alert) {
+  if ((_requested.load(std::memory_order_relaxed) & alert) == 0x0) return;
+
+  const uint8_t index = __builtin_ctz(alert);
+  _clearTime[index].store(millis(), std::memory_order_relaxed);
+  const uint32_t previous =
+      _requested.fetch_and(~alert, std::memory_order_acq_rel);
+  if ((previous & alert) == 0x0) return;
+
+  _sequence.fetch_add(1, std::memory_order_release);
+  tracer::trace(tracer::Event::ALERT_CLEARED, alert);
+}
+
+void Alert::update(const uint32_t time) {
+  const uint32_t requested = _requested.load(std::memory_order_acquire);
+  const uint32_t current = _current.load(std::memory_order_relaxed);
+
+  // only visit the alerts waiting for their raise or clear delay
+  uint32_t pending = requested ^ current;
+  uint32_t newCurrent = current;
+  while (pending != 0) {
+    const uint8_t index = __builtin_ctz(pending);
+    const uint32_t bit = 1ul << index;
+    pending ^= bit;
+
+    // signed durations: a request from another task can be newer than time
+    const AlertDescriptor& descriptor = descriptors[index];
+    if ((requested & bit) != 0x0) {
+      const int32_t raisedSince = time - get_raise_time(index);
+      if (raisedSince >= descriptor.raiseDelay_ms) {
+        newCurrent |= bit;
+        _activeTime[index].store(time, std::memory_order_relaxed);
+      }
+    } else {
+      const int32_t clearedSince = time - get_clear_time(index);
+      if (clearedSince >= descriptor.clearDelay_ms) {
+        newCurrent &= ~bit;
+      }
+    }
+  }
+
+  if (newCurrent != current) {
+    // single writer: a plain store is enough
+    _current.store(newCurrent, std::memory_order_release);
+    _sequence.fetch_add(1, std::memory_order_release);
+  }
+}
@@ -1,45 +1,134 @@
 #ifndef ALERTS_H
 #define ALERTS_H
 
+#include <atomic>
 #include <cstdint>
 
+#include "utils/tracer.h"
+
 // 32 errors max
 enum Alerts {
   NONE = 0,  // system is sane and ready
 
-  // always sort them by importance
-  MAIN_LOOP_FREEZE = 1 << 0,  // main loop does not respond
+  // always sort them by importance, the lowest bit is displayed: the alerts
+  // that shut the lamp down first. The priority of the descriptors
+  // (alerts.cpp) is checked against this order at compile time
+  TEMP_CRITICAL = 1 << 0,     // Processor temperature is critical
+  BATTERY_CRITICAL = 1 << 1,  // battery is too low, shutdown immediatly
+  MAIN_LOOP_FREEZE = 1 << 2,  // main loop does not respond
   BATTERY_READINGS_INCOHERENT =
-      1 << 1,  // the pin that reads the battery value is not coherent with
+      1 << 3,  // the pin that reads the battery value is not coherent with
                // it's givent min and max
-  BATTERY_CRITICAL = 1 << 2,  // battery is too low, shutdown immediatly
-  BATTERY_LOW = 1 << 3,       // battery is dangerously low
-  LONG_LOOP_UPDATE = 1 << 4,  // the main loop is taking too long to execute
+  TEMP_TOO_HIGH = 1 << 4,     // Processor temperature is too high
+  BATTERY_LOW = 1 << 5,       // battery is dangerously low
+  LONG_LOOP_UPDATE = 1 << 6,  // the main loop is taking too long to execute
                               // (bugs when reading button inputs)
-  TEMP_TOO_HIGH = 1 << 5,     // Processor temperature is too high
-  TEMP_CRITICAL = 1 << 6,     // Processor temperature is critical
 
   BLUETOOTH_ADVERT = 1 << 7,  // bluetooth is advertising
 };
 
+// number of declared alerts (one bit each)
+static constexpr uint8_t alertCount = 8;
+
+// never shutdown because of this alert
+static constexpr uint32_t noShutdown = UINT32_MAX;
+
+// button pattern displayed for an alert
+enum class Indicator : uint8_t {
+  BLINK = 0,  // on/off blink
+  BREEZE,     // fade in/fade out
+  COUNT
+};
+
+/**
+ * \brief Static description of an alert, the alert behavior is driven by this
+ */
+struct AlertDescriptor {
+  const char* name;
+  uint8_t priority;  // display order, 0 first: must follow the bit order
+  Indicator indicator;
+  uint32_t color;             // indicator color, 0xRRGGBB
+  uint16_t onTime_ms;         // indicator on time (breeze: fade in time)
+  uint16_t offTime_ms;        // indicator off time (breeze: fade out time)
+  uint8_t brightnessCap;      // highest brightness allowed while active
+  uint16_t raiseDelay_ms;     // raised for this long before being active
+  uint16_t clearDelay_ms;     // cleared for this long before being inactive
+  uint32_t shutdownDelay_ms;  // active for this long: shutdown the lamp
+  bool shouldDisableBluetooth;
+};
+
+/**
+ * \brief Return the descriptor of an alert, by bit index
+ */
+const AlertDescriptor& get_alert_descriptor(const uint8_t index);
+
+/**
+ * \brief Alert state, safe to raise and clear from any task or interrupt.
+ * The masks are updated with atomic fetch or/fetch and (LDREX/STREX on the
+ * cortex M4), so concurrent raise and clear requests are never lost.
+ */
 class Alert {
  public:
-  void raise_alert(const Alerts alert) {
-    if (alert == Alerts::NONE) return;
-    _current |= alert;
+  /**
+   * \brief Request an alert, it becomes active after its raise delay
+   */
+  void raise_alert(const Alerts alert);
+
+  /**
+   * \brief Clear an alert, it becomes inactive after its clear delay
+   */
+  void clear_alert(const Alerts alert);
+
+  /**
+   * \brief Apply the raise and clear delays of the requested alerts.
+   * Only one task should call this.
+   * \param[in] time The current time in milliseconds
+   */
+  void update(const uint32_t time);
+
+  // active alerts
+  uint32_t current() const { return _current.load(std::memory_order_acquire); }
+
+  /**
+   * \brief Incremented on every requested or active alert change. Consumers
+   * can skip their work when it did not change since their last call
+   */
+  uint32_t get_change_sequence() const {
+    return _sequence.load(std::memory_order_acquire);
+  }
+
+  /**
+   * \brief Return the bit index of the most important active alert
+   * Undefined when no alert is active
+   */
+  uint8_t get_highest_index() const {
+    // lowest set bit is the most important alert: RBIT + CLZ on cortex M4
+    return __builtin_ctz(current());
   }
 
-  void clear_alert(const Alerts alert) {
-    if ((_current & alert) == 0x0) return;
-    _current ^= alert;
+  // time of the last raise/clear request of an alert, by bit index
+  uint32_t get_raise_time(const uint8_t index) const {
+    return _raiseTime[index].load(std::memory_order_relaxed);
+  }
+  uint32_t get_clear_time(const uint8_t index) const {
+    return _clearTime[index].load(std::memory_order_relaxed);
   }
 
-  uint32_t current() const { return _current; }
+  // time at which an alert became active, by bit index
+  uint32_t get_active_time(const uint8_t index) const {
+    return _activeTime[index].load(std::memory_order_relaxed);
+  }
 
  private:
-  uint32_t _current;
+  std::atomic<uint32_t> _requested{0};  // raised alerts, before the delays
+  std::atomic<uint32_t> _current{0};    // active alerts
+  std::atomic<uint32_t> _sequence{0};   // change counter
+
+  std::atomic<uint32_t> _raiseTime[alertCount] = {};
+  std::atomic<uint32_t> _clearTime[alertCount] = {};
+  std::atomic<uint32_t> _activeTime[alertCount] = {};
 };
 
 extern Alert AlertManager;
 
-#endif
\ No newline at end of file
+#endif
@@ -1,9 +1,12 @@
 #include "behavior.h"
 
+#include <atomic>
+#include <cmath>
 #include <cstdint>
 
 #include "../user_functions.h"
 #include "alerts.h"
+#include "charge_idle.h"
 #include "charger/charger.h"
 #include "ext/math8.h"
 #include "ext/noise.h"
@@ -14,11 +17,15 @@
 #include "physical/button.h"
 #include "physical/fileSystem.h"
 #include "physical/led_power.h"
+#include "scheduler.h"
+#include "thermal.h"
 #include "utils/colorspace.h"
 #include "utils/constants.h"
+#include "utils/ramp.h"
 #include "utils/utils.h"
 
 const char* brightnessKey = "brightness";
+const char* stateOfChargeKey = "soc";  // hundredths of percent
 
 // constantes
 static constexpr uint8_t MIN_BRIGHTNESS = 5;
@@ -26,6 +33,9 @@ static constexpr uint8_t MAX_BRIGHTNESS = 255;
 
 static uint8_t MaxBrightnessLimit =
     MAX_BRIGHTNESS;  // temporary upper bound for the brightness
+// limit requested by the alerts (power thread), applied by the animation
+// thread, the only writer of the brightness
+static std::atomic<uint8_t> requestedBrightnessLimit(MAX_BRIGHTNESS);
 
 // hold the current level of brightness out of the raise/lower animation
 uint8_t BRIGHTNESS = 50;  // default start value
@@ -58,6 +68,11 @@ void read_parameters() {
     update_brightness(brightness, true, true);
   }
 
+  uint32_t stateOfCharge = 0;
+  if (fileSystem::get_value(std::string(stateOfChargeKey), stateOfCharge)) {
+    battery::restore_state_of_charge(stateOfCharge / 100.0);
+  }
+
   user::read_parameters();
 }
 
@@ -65,13 +80,32 @@ void write_parameters() {
   fileSystem::clear();
   fileSystem::set_value(std::string(brightnessKey), BRIGHTNESS);
 
+  const float stateOfCharge = battery::get_state_of_charge();
+  if (not std::isnan(stateOfCharge)) {
+    fileSystem::set_value(std::string(stateOfChargeKey),
+                          stateOfCharge * 100.0);
+  }
+
   user::write_parameters();
 
   fileSystem::write_state();
 }
 
-static bool isShutdown = true;
-bool is_shutdown() { return isShutdown; }
+// written by the animation thread, read by all the threads
+static std::atomic<bool> isShutdown(true);
+bool is_shutdown() { return isShutdown.load(); }
+
+// shutdown requested by another thread, run by the animation thread
+static std::atomic<bool> isShutdownRequested(false);
+
+void request_shutdown() {
+  isShutdownRequested.store(true);
+  scheduler::wake(scheduler::Task::DISPLAY);
+}
+
+void update_shutdown_request() {
+  if (isShutdownRequested.exchange(false)) shutdown();
+}
 
 void startup_sequence() {
   // initialize the battery level
@@ -175,6 +209,63 @@ void button_clicked_callback(const uint8_t consecutiveButtonCheck) {
 }
 
 #define BRIGHTNESS_RAMP_DURATION_MS 2000
+#define BRIGHTNESS_RAMP_STEP_MS 10
+
+// brightness ramps are stepped by the animation thread, like every call to
+// user::brightness_update. A software timer wakes that thread at each step, so
+// the steps keep their period when the user loop is late
+static utils::Ramp brightnessRamp;
+static SoftwareTimer brightnessRampTimer;
+// a ramp is started at the beginning of a hold event
+static bool isHoldRampStarted = false;
+// a ramp is running, stepped by update_brightness_ramp
+static bool isRampRunning = false;
+
+static void brightness_ramp_timer(TimerHandle_t) {
+  // runs in the timer task: no user code here, only wake the user loop
+  scheduler::wake(scheduler::Task::USER);
+}
+
+void update_brightness_ramp() {
+  if (not isRampRunning) return;
+
+  const uint32_t time = millis();
+  update_brightness(brightnessRamp.get(time));
+
+  if (brightnessRamp.is_finished(time)) {
+    isRampRunning = false;
+    brightnessRampTimer.stop();
+  }
+}
+
+/**
+ * \brief Ramp the brightness from currentBrightness to a target
+ * \param[in] target the final brightness
+ * \param[in] startTime time of the start of the ramp
+ */
+static void start_brightness_ramp(const uint8_t target,
+                                  const uint32_t startTime) {
+  static constexpr float brightnessDivider =
+      1.0 / float(MAX_BRIGHTNESS - MIN_BRIGHTNESS);
+
+  // constant speed: the full range takes BRIGHTNESS_RAMP_DURATION_MS
+  const float distance =
+      float(max(target, currentBrightness) - min(target, currentBrightness));
+  const uint32_t duration =
+      BRIGHTNESS_RAMP_DURATION_MS * distance * brightnessDivider;
+
+  brightnessRamp.start(currentBrightness, target, duration,
+                       utils::Ramp::Easing::Linear, startTime);
+
+  isRampRunning = true;
+
+  static bool isTimerInitialized = false;
+  if (not isTimerInitialized) {
+    brightnessRampTimer.begin(BRIGHTNESS_RAMP_STEP_MS, brightness_ramp_timer);
+    isTimerInitialized = true;
+  }
+  brightnessRampTimer.start();
+}
 
 void button_hold_callback(const uint8_t consecutiveButtonCheck,
                           const uint32_t buttonHoldDuration) {
@@ -187,40 +278,22 @@ void button_hold_callback(const uint8_t consecutiveButtonCheck,
   const bool isEndOfHoldEvent = buttonHoldDuration <= 1;
   const uint32_t holdDuration = buttonHoldDuration - HOLD_BUTTON_MIN_MS;
 
-  static constexpr float brightnessDivider =
-      1.0 / float(MAX_BRIGHTNESS - MIN_BRIGHTNESS);
-
   switch (consecutiveButtonCheck) {
     case 1:  // just hold the click
-      if (!isEndOfHoldEvent) {
-        const float percentOfTimeToGoUp =
-            float(MAX_BRIGHTNESS - currentBrightness) * brightnessDivider;
-
-        const auto newBrightness =
-            map(min(holdDuration,
-                    BRIGHTNESS_RAMP_DURATION_MS * percentOfTimeToGoUp),
-                0, BRIGHTNESS_RAMP_DURATION_MS * percentOfTimeToGoUp,
-                currentBrightness, MAX_BRIGHTNESS);
-        update_brightness(newBrightness);
-      } else {
-        // switch brightness
-        currentBrightness = BRIGHTNESS;
-      }
-      break;
-
     case 2:  // 2 click and hold
-             // lower luminositity
       if (!isEndOfHoldEvent) {
-        const double percentOfTimeToGoDown =
-            float(currentBrightness - MIN_BRIGHTNESS) * brightnessDivider;
-
-        const auto newBrightness =
-            map(min(holdDuration,
-                    BRIGHTNESS_RAMP_DURATION_MS * percentOfTimeToGoDown),
-                0, BRIGHTNESS_RAMP_DURATION_MS * percentOfTimeToGoDown,
-                currentBrightness, MIN_BRIGHTNESS);
-        update_brightness(newBrightness);
+        if (!isHoldRampStarted) {
+          // 1 click raises the luminosity, 2 clicks lower it
+          start_brightness_ramp(
+              (consecutiveButtonCheck == 1) ? MAX_BRIGHTNESS : MIN_BRIGHTNESS,
+              millis() - holdDuration);
+          isHoldRampStarted = true;
+        }
       } else {
+        brightnessRampTimer.stop();
+        isRampRunning = false;
+        isHoldRampStarted = false;
+
         // switch brightness
         currentBrightness = BRIGHTNESS;
       }
@@ -233,75 +306,143 @@ void button_hold_callback(const uint8_t consecutiveButtonCheck,
   }
 }
 
+/**
+ * \brief Set the brightness upper bound. The brightness is lowered to the
+ * limit, and goes back to the user brightness when the limit rises again
+ */
+static void limit_brightness(const uint8_t limit) {
+  MaxBrightnessLimit = limit;
+  if (BRIGHTNESS > limit) {
+    update_brightness(limit);
+  } else if (not isShutdown and not isHoldRampStarted and
+             BRIGHTNESS < currentBrightness) {
+    update_brightness(min(limit, currentBrightness));
+  }
+}
+
+void update_brightness_limit() {
+  limit_brightness(requestedBrightnessLimit.load());
+}
+
+/**
+ * \brief Request a brightness upper bound from another thread, applied by
+ * update_brightness_limit
+ */
+static void request_brightness_limit(const uint8_t limit) {
+  if (requestedBrightnessLimit.exchange(limit) != limit) {
+    scheduler::wake(scheduler::Task::DISPLAY);
+  }
+}
+
+// button pattern of the alerts, posted by the power thread and displayed by
+// the animation thread, the only writer of the button outputs
+struct ButtonPattern {
+  bool isAnimated;      // else a solid color
+  Indicator indicator;  // animation, if isAnimated
+  uint32_t color;       // 0xRRGGBB
+  uint16_t onTime_ms;
+  uint16_t offTime_ms;
+};
+// a mailbox: a new pattern replaces the one not displayed yet
+static QueueHandle_t buttonPatterns = nullptr;
+
+void setup_alert_display() {
+  buttonPatterns = xQueueCreate(1, sizeof(ButtonPattern));
+}
+
+static void post_button_pattern(const ButtonPattern& pattern) {
+  xQueueOverwrite(buttonPatterns, &pattern);
+}
+
+// alert indicators, indexed by Indicator
+static void blink_indicator(const ButtonPattern& pattern) {
+  button::blink(pattern.offTime_ms, pattern.onTime_ms,
+                utils::ColorSpace::RGB(pattern.color));
+}
+static void breeze_indicator(const ButtonPattern& pattern) {
+  button::breeze(pattern.onTime_ms, pattern.offTime_ms,
+                 utils::ColorSpace::RGB(pattern.color));
+}
+static void (*const indicators[])(const ButtonPattern&) = {blink_indicator,
+                                                           breeze_indicator};
+static_assert(sizeof(indicators) / sizeof(indicators[0]) ==
+                  static_cast<uint8_t>(Indicator::COUNT),
+              "one indicator function by indicator pattern");
+
+void update_alert_display() {
+  static ButtonPattern pattern;
+  static bool hasPattern = false;
+  if (xQueueReceive(buttonPatterns, &pattern, 0) == pdTRUE) {
+    hasPattern = true;
+    if (not pattern.isAnimated) {
+      button::set_color(utils::ColorSpace::RGB(pattern.color));
+    }
+  }
+
+  // the animations compute a frame at each call
+  if (hasPattern and pattern.isAnimated) {
+    indicators[static_cast<uint8_t>(pattern.indicator)](pattern);
+  }
+}
+
 void handle_alerts() {
+  const uint32_t time = millis();
+  AlertManager.update(time);
   const uint32_t current = AlertManager.current();
 
+  // the active alerts only change in update(), on this task
+  static uint32_t lastSequence = 0;
+  const uint32_t sequence = AlertManager.get_change_sequence();
+  const bool hasChanged = sequence != lastSequence;
+  lastSequence = sequence;
+
+  // highest brightness the lamp can sustain without overheating
+  const uint8_t thermalLimit = thermal::get_brightness_limit(MAX_BRIGHTNESS);
+
   const bool isChargeOk = charger::charge_processus();
 
-  static uint32_t criticalbatteryRaisedTime = 0;
   if (current == Alerts::NONE) {
-    MaxBrightnessLimit = MAX_BRIGHTNESS;
-    criticalbatteryRaisedTime = 0;
+    request_brightness_limit(thermalLimit);
 
-    // red to green
-    const auto buttonColor = utils::ColorSpace::RGB(
-        utils::get_gradient(utils::ColorSpace::RED.get_rgb().color,
-                            utils::ColorSpace::GREEN.get_rgb().color,
-                            battery::get_battery_level() / 100.0));
+    // red to green, interpolated once by tick: no table needed
+    const float batteryLevel = battery::get_battery_level() / 100.0f;
+    const uint32_t buttonColor =
+        utils::ColorSpace::oklab_blend(utils::ColorSpace::RED.get_rgb(),
+                                       utils::ColorSpace::GREEN.get_rgb(),
+                                       batteryLevel)
+            .color;
 
     // display battery level
-    if (isChargeOk) {
+    if (isChargeOk and !charge_idle::is_idle()) {
       // charge mode
-      button::breeze(2000, 2000, buttonColor);
+      post_button_pattern({true, Indicator::BREEZE, buttonColor, 2000, 2000});
     } else {
-      // normal mode
-      button::set_color(buttonColor);
-    }
-  } else {
-    if ((current & Alerts::TEMP_CRITICAL) != 0x00) {
-      // shutdown when battery is critical
-      shutdown();
-    } else if ((current & Alerts::TEMP_TOO_HIGH) != 0x00) {
-      // proc temperature is too high, blink orange
-      button::blink(300, 300, utils::ColorSpace::ORANGE);
-
-      // limit brightness to half the max value
-      constexpr uint8_t clampedBrightness = 0.5 * MAX_BRIGHTNESS;
-      MaxBrightnessLimit = clampedBrightness;
-      update_brightness(min(clampedBrightness, BRIGHTNESS));
-    } else if ((current & Alerts::BATTERY_READINGS_INCOHERENT) != 0x00) {
-      // incohrent battery readings
-      button::blink(100, 100, utils::ColorSpace::GREEN);
-    } else if ((current & Alerts::BATTERY_CRITICAL) != 0x00) {
-      // critical battery alert: shutdown after 2 seconds
-      if (criticalbatteryRaisedTime == 0)
-        criticalbatteryRaisedTime = millis();
-      else if (millis() - criticalbatteryRaisedTime > 2000) {
-        // shutdown when battery is critical
-        shutdown();
-      }
-      // blink if no shutdown
-      button::blink(100, 100, utils::ColorSpace::RED);
-    } else if ((current & Alerts::BATTERY_LOW) != 0x00) {
-      criticalbatteryRaisedTime = 0;
-      // fast blink red
-      button::blink(300, 300, utils::ColorSpace::RED);
-
-      // limit brightness to quarter of the max value
-      constexpr uint8_t clampedBrightness = 0.25 * MAX_BRIGHTNESS;
-      MaxBrightnessLimit = clampedBrightness;
-
-      // save some battery
-      bluetooth::disable_bluetooth();
-      update_brightness(min(clampedBrightness, BRIGHTNESS));
-    } else if ((current & Alerts::LONG_LOOP_UPDATE) != 0x00) {
-      // fast blink red
-      button::blink(400, 400, utils::ColorSpace::FUSHIA);
-    } else if ((current & Alerts::BLUETOOTH_ADVERT) != 0x00) {
-      button::breeze(1000, 500, utils::ColorSpace::BLUE);
-    } else {
-      // unhandled case (white blink)
-      button::blink(300, 300, utils::ColorSpace::WHITE);
+      // normal mode, or charge idle (no animation frames)
+      post_button_pattern({false, Indicator::BLINK, buttonColor, 0, 0});
     }
+    return;
+  }
+
+  // only the most important alert drives the lamp
+  static uint8_t index = 0;
+  if (hasChanged) {
+    index = AlertManager.get_highest_index();
+  }
+  const AlertDescriptor& alert = get_alert_descriptor(index);
+
+  if (alert.shutdownDelay_ms != noShutdown and
+      time - AlertManager.get_active_time(index) >= alert.shutdownDelay_ms) {
+    // this runs in the power thread
+    if (not is_shutdown()) request_shutdown();
+    return;
+  }
+
+  post_button_pattern(
+      {true, alert.indicator, alert.color, alert.onTime_ms, alert.offTime_ms});
+
+  // alerts changed (bluetooth advertising restarted for instance)
+  if (hasChanged and alert.shouldDisableBluetooth) {
+    bluetooth::disable_bluetooth();
   }
+  request_brightness_limit(min(alert.brightnessCap, thermalLimit));
 }
\ No newline at end of file
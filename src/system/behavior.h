@@ -23,13 +23,37 @@ extern bool is_shutdown();
 // systems
 extern void startup_sequence();
 
-// put in shutdown mode, with external wakeup
+// put in shutdown mode, with external wakeup. Call from the animation thread
 extern void shutdown();
 
+/**
+ * \brief Request a shutdown from another thread. The animation thread runs it
+ * in update_shutdown_request
+ */
+extern void request_shutdown();
+
+/**
+ * \brief Run the requested shutdown, if any. Call from the animation thread
+ */
+extern void update_shutdown_request();
+
 extern void update_brightness(const uint8_t newBrightness,
                               const bool shouldUpdateCurrentBrightness = false,
                               const bool isInitialRead = false);
 
+/**
+ * \brief Apply the next step of the running brightness ramp, if any. Call
+ * from the animation thread, before the user loop
+ */
+extern void update_brightness_ramp();
+
+/**
+ * \brief Apply the brightness limit requested by the alerts: lower the
+ * brightness under it, or restore the user brightness when it rises. Call
+ * from the animation thread
+ */
+extern void update_brightness_limit();
+
 /**
  * \brief callback of the button clicked sequence event
  */
@@ -41,7 +65,21 @@ extern void button_clicked_callback(const uint8_t consecutiveButtonCheck);
 extern void button_hold_callback(const uint8_t consecutiveButtonCheck,
                                  const uint32_t buttonHoldDuration);
 
-// If any alert is set, will handle it
+// If any alert is set, will handle it. The brightness limit and the button
+// pattern of the alerts are applied by the animation thread
+// (update_brightness_limit and update_alert_display)
 extern void handle_alerts();
 
+/**
+ * \brief Create the mailbox of the alert button pattern. Call in setup,
+ * before the threads start
+ */
+extern void setup_alert_display();
+
+/**
+ * \brief Display the button pattern posted by handle_alerts: next frame of
+ * its animation, or its color. Call from the animation thread
+ */
+extern void update_alert_display();
+
 #endif
\ No newline at end of file
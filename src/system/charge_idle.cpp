@@ -0,0 +1,88 @@
+#include "charge_idle.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "alerts.h"
+#include "charger/charger.h"
+#include "scheduler.h"
+
+namespace charge_idle {
+
+// wake up rates are measured on windows of this duration (ms)
+static constexpr uint32_t rateWindow_ms = 10000;
+
+// written by the power thread (update) and the input thread (button activity)
+static std::atomic<State> state(State::ACTIVE);
+static std::atomic<uint32_t> lastActivityTime(0);
+static float wakeupsPerSecond[static_cast<uint8_t>(State::COUNT)] = {0.0};
+
+// fast updates for all the tasks that slow down when idle
+static void wake_idle_tasks() {
+  scheduler::wake(scheduler::Task::BUTTON);
+  scheduler::wake(scheduler::Task::DISPLAY);
+  scheduler::wake(scheduler::Task::ALERTS);
+}
+
+void notify_activity() {
+  // the time first: update checks it after going idle
+  lastActivityTime.store(millis());
+  if (state.exchange(State::ACTIVE) == State::IDLE) {
+    wake_idle_tasks();
+  }
+}
+
+State get_state() { return state.load(); }
+
+float get_wakeups_per_second(const State measuredState) {
+  return wakeupsPerSecond[static_cast<uint8_t>(measuredState)];
+}
+
+// wake up rate of the current state, on complete windows only
+static void measure_wakeups(const uint32_t time) {
+  static State windowState = State::ACTIVE;
+  static uint32_t windowStart = 0;
+  static uint32_t windowWakeups = 0;
+
+  const State currentState = state.load();
+  const uint32_t wakeups = scheduler::get_wakeup_count();
+  const uint32_t duration = time - windowStart;
+  if (currentState == windowState and duration < rateWindow_ms) return;
+
+  if (currentState == windowState) {
+    wakeupsPerSecond[static_cast<uint8_t>(currentState)] =
+        (wakeups - windowWakeups) * 1000.0 / duration;
+  }
+  // else: the state changed, the window is not valid
+
+  windowState = currentState;
+  windowStart = time;
+  windowWakeups = wakeups;
+}
+
+void update(const bool isShutdown) {
+  const uint32_t time = millis();
+
+  // any of those keeps the fast updates
+  static bool wasCharging = false;
+  const bool isCharging = charger::is_charging();
+  if (!isShutdown or !charger::is_usb_powered() or
+      AlertManager.current() != Alerts::NONE or isCharging != wasCharging) {
+    notify_activity();
+  }
+  wasCharging = isCharging;
+
+  // the charge is stable, nothing to display
+  const uint32_t activityTime = lastActivityTime.load();
+  if (state.load() == State::ACTIVE and time - activityTime > idleDelay_ms) {
+    state.store(State::IDLE);
+    // an activity notified meanwhile may have seen the active state and
+    // skipped the wake up: leave the idle state again
+    if (lastActivityTime.load() != activityTime) notify_activity();
+  }
+
+  measure_wakeups(time);
+}
+
+}  // namespace charge_idle
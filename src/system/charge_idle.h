@@ -0,0 +1,55 @@
+#ifndef CHARGE_IDLE_H
+#define CHARGE_IDLE_H
+
+#include <cstdint>
+
+/// Low power state of the lamp when it is shut down but charging: the button,
+/// display and alert tasks poll once per second (charge supervision) instead
+/// of every loop period. The button and PD controller interrupts still wake
+/// their threads. The FreeRTOS tick keeps running, this is not a sleep until
+/// an RTC or GPIO event.
+namespace charge_idle {
+
+enum class State : uint8_t {
+  ACTIVE = 0,  // lamp on, or recent activity: fast update periods
+  IDLE,        // shut down on USB power, nothing to display
+
+  COUNT
+};
+
+// update period of the idle tasks (ms)
+constexpr uint32_t idlePeriod_ms = 1000;
+// time without activity before entering the idle state (ms)
+constexpr uint32_t idleDelay_ms = 5000;
+
+/**
+ * \brief Run the state machine, call at every alert update
+ * \param[in] isShutdown is the lamp shut down
+ */
+void update(const bool isShutdown);
+
+/**
+ * \brief Signal an activity (button), leave the idle state immediately
+ */
+void notify_activity();
+
+State get_state();
+inline bool is_idle() { return get_state() == State::IDLE; }
+
+/**
+ * \brief Update period of a task in the current state
+ * \param[in] activePeriod_ms the period out of the idle state
+ */
+inline uint32_t get_period(const uint32_t activePeriod_ms) {
+  return is_idle() ? idlePeriod_ms : activePeriod_ms;
+}
+
+/**
+ * \brief Last measured number of thread wake ups per second in a state
+ * \return 0 if the state was never measured
+ */
+float get_wakeups_per_second(const State state);
+
+}  // namespace charge_idle
+
+#endif
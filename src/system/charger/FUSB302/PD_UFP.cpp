@@ -18,6 +18,11 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "../../physical/i2c.h"
+#include "../../scheduler.h"
+#include "../../utils/ring_buffer.h"
+#include "../../utils/tracer.h"
+
 #define t_PD_POLLING 100
 #define t_TypeCSinkWaitCap 300  // 350
 #define t_RequestToPSReady 580  // combine t_SenderResponse and t_PSTransition
@@ -87,9 +92,13 @@ void PD_UFP_c::init(uint8_t int_pin, enum PD_power_option_t power_option) {
   init_PPS(int_pin, 0, 0, power_option);
 }
 
-// notify when the ic sends an interrupt signal
-bool interruptSet = false;
-void ic_interrupt() { interruptSet = true; }
+// interrupt signals sent by the ic (millis)
+static utils::RingBuffer<uint32_t, 8> interruptEvents;
+void ic_interrupt() {
+  interruptEvents.push(millis());
+  // the PD negociation runs with the alerts
+  scheduler::wake_from_isr(scheduler::Task::ALERTS);
+}
 
 void PD_UFP_c::init_PPS(uint8_t int_pin, uint16_t PPS_voltage,
                         uint8_t PPS_current,
@@ -125,8 +134,9 @@ void PD_UFP_c::init_PPS(uint8_t int_pin, uint16_t PPS_voltage,
 }
 
 void PD_UFP_c::run(void) {
-  if (timer() || interruptSet) {
-    interruptSet = false;
+  if (timer() || !interruptEvents.is_empty()) {
+    // the ic status is read once for all the pending interrupts
+    interruptEvents.clear();
 
     FUSB302_event_t FUSB302_events = 0;
     for (uint8_t i = 0;
@@ -178,6 +188,7 @@ uint16_t PD_UFP_c::get_vbus_voltage() {
 
 FUSB302_ret_t PD_UFP_c::FUSB302_i2c_read(uint8_t dev_addr, uint8_t reg_addr,
                                          uint8_t *data, uint8_t count) {
+  i2c::Lock lock;
   Wire.beginTransmission(dev_addr);
   Wire.write(reg_addr);
   Wire.endTransmission();
@@ -191,6 +202,7 @@ FUSB302_ret_t PD_UFP_c::FUSB302_i2c_read(uint8_t dev_addr, uint8_t reg_addr,
 
 FUSB302_ret_t PD_UFP_c::FUSB302_i2c_write(uint8_t dev_addr, uint8_t reg_addr,
                                           uint8_t *data, uint8_t count) {
+  i2c::Lock lock;
   Wire.beginTransmission(dev_addr);
   Wire.write(reg_addr);
   while (count > 0) {
@@ -207,6 +219,7 @@ FUSB302_ret_t PD_UFP_c::FUSB302_delay_ms(uint32_t t) {
 }
 
 void PD_UFP_c::handle_protocol_event(PD_protocol_event_t events) {
+  tracer::trace(tracer::Event::PD_PROTOCOL_EVENT, events);
   if (events & PD_PROTOCOL_EVENT_SRC_CAP) {
     wait_src_cap = 0;
     get_src_cap_retry_count = 0;
@@ -246,6 +259,7 @@ void PD_UFP_c::handle_protocol_event(PD_protocol_event_t events) {
 }
 
 void PD_UFP_c::handle_FUSB302_event(FUSB302_event_t events) {
+  tracer::trace(tracer::Event::PD_IC_EVENT, events);
   if (events & FUSB302_EVENT_DETACHED) {
     isPowerNegociated = false;
     reset();
@@ -341,6 +355,9 @@ void PD_UFP_c::set_default_power(void) {
 
 void PD_UFP_c::status_power_ready(status_power_t status, uint16_t voltage,
                                   uint16_t current) {
+  tracer::trace(tracer::Event::PD_POWER_READY,
+                (uint32_t(status) << 24) | (uint32_t(voltage & 0xFFF) << 12) |
+                    (current & 0xFFF));
   ready_voltage = voltage;
   ready_current = current;
   status_power = status;
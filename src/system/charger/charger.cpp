@@ -296,6 +296,43 @@ void disable_charge() {
   BQ25703Areg.chargeCurrent.set_current(baseChargeCurrent_mA);
 }
 
+bool get_discharge_measures(uint16_t& dischargeCurrent_mA,
+                            float& systemPower_W) {
+  // results of the last conversion (get_IDCHG does not read the register)
+  if (not charger.readRegEx(BQ25703Areg.aDCIBAT)) return false;
+  dischargeCurrent_mA = BQ25703Areg.aDCIBAT.get_IDCHG();
+  systemPower_W = BQ25703Areg.aDCVBUSPSYS.get_sysPower();
+
+  // the ADC runs continuously while charging, else start the next conversion
+  if (BQ25703Areg.aDCOption.ADC_CONV() == 0) {
+    // battery current and system power buffers
+    if (BQ25703Areg.chargeOption1.EN_IBAT() == 0 or
+        BQ25703Areg.chargeOption1.EN_PSYS() == 0) {
+      BQ25703Areg.chargeOption1.set_EN_IBAT(1);
+      BQ25703Areg.chargeOption1.set_EN_PSYS(1);
+      charger.writeRegEx(BQ25703Areg.chargeOption1);
+    }
+
+    BQ25703Areg.aDCOption.set_EN_ADC_IDCHG(1);
+    BQ25703Areg.aDCOption.set_EN_ADC_PSYS(1);
+    BQ25703Areg.aDCOption.set_ADC_START(1);
+    charger.writeRegEx(BQ25703Areg.aDCOption);
+    // the start bit is cleared by the charger at the end of the conversion
+    BQ25703Areg.aDCOption.set_ADC_START(0);
+  }
+  return true;
+}
+
+bool get_battery_current(int32_t& current_mA) {
+  if (not charger.readRegEx(BQ25703Areg.aDCIBAT)) return false;
+  current_mA = -static_cast<int32_t>(BQ25703Areg.aDCIBAT.get_IDCHG());
+  // the charge current register holds the last charge value
+  if (isCharging_s) {
+    current_mA += BQ25703Areg.aDCIBAT.get_ICHG();
+  }
+  return true;
+}
+
 String charge_status() { return status; }
 
 uint16_t getVbusVoltage_mV() { return PD_UFP.get_vbus_voltage(); }
@@ -27,6 +27,25 @@ void disable_charge();
 // return the current charge status, or status of the last charge action
 String charge_status();
 
+/**
+ * \brief Read the battery discharge current and the system power.
+ * When the ADC is not in continuous mode (not charging), each call starts the
+ * next one shot conversion, and returns the result of the previous one.
+ * \param[out] dischargeCurrent_mA battery discharge current (mA)
+ * \param[out] systemPower_W system power (Watts)
+ * \return false if the charger could not be read
+ */
+bool get_discharge_measures(uint16_t& dischargeCurrent_mA,
+                            float& systemPower_W);
+
+/**
+ * \brief Read the battery current measured by the charger ADC.
+ * The charge current is only converted while charging, it counts as 0 else.
+ * \param[out] current_mA battery current (mA), positive when charging
+ * \return false if the charger could not be read
+ */
+bool get_battery_current(int32_t& current_mA);
+
 // return the read value of vBus voltage (milliVolts)
 uint16_t getVbusVoltage_mV();
 
@@ -131,6 +131,34 @@ LIB8STATIC_ALWAYS_INLINE uint8_t qsub8(uint8_t i, uint8_t j) {
 #endif
 }
 
+/// Add one uint16_t to another, saturating at 0xFFFF
+/// @param i first value to add
+/// @param j second value to add
+/// @returns the sum of i + j, capped at 0xFFFF
+LIB8STATIC_ALWAYS_INLINE uint16_t qadd16(uint16_t i, uint16_t j) {
+#if QADD16_C == 1
+  uint32_t t = (uint32_t)(i) + (uint32_t)(j);
+  if (t > 65535) t = 65535;
+  return t;
+#else
+#error "No implementation for qadd16 available."
+#endif
+}
+
+/// Subtract one uint16_t from another, saturating at 0x0000
+/// @param i value to subtract from
+/// @param j value to subtract
+/// @returns i - j with a floor of 0
+LIB8STATIC_ALWAYS_INLINE uint16_t qsub16(uint16_t i, uint16_t j) {
+#if QSUB16_C == 1
+  int32_t t = (int32_t)(i) - (int32_t)(j);
+  if (t < 0) t = 0;
+  return t;
+#else
+#error "No implementation for qsub16 available."
+#endif
+}
+
 /// Add one byte to another, with 8-bit result
 /// @note This does not saturate and may overflow!
 /// @param i first byte to add
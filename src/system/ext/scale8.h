@@ -7,6 +7,8 @@
 #define QADD8_C 1
 #define QADD7_C 1
 #define QSUB8_C 1
+#define QADD16_C 1
+#define QSUB16_C 1
 #define SCALE8_C 1
 #define SCALE16BY8_C 1
 #define SCALE16_C 1
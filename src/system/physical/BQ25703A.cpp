@@ -12,6 +12,9 @@
 
 #include <Wire.h>
 
+#include "../utils/tracer.h"
+#include "i2c.h"
+
 #include "Arduino.h"
 
 namespace bq2573a {
@@ -28,6 +31,7 @@ BQ25703A::BQ25703A() {}
 
 boolean BQ25703A::readDataReg(const byte regAddress, byte *dataVal,
                               const uint8_t arrLen) {
+  i2c::Lock lock;
   Wire.beginTransmission(BQ25703Aaddr);
   if (!Wire.write(regAddress)) return false;
 
@@ -47,6 +51,10 @@ boolean BQ25703A::readDataReg(const byte regAddress, byte *dataVal,
 
 boolean BQ25703A::writeDataReg(const byte regAddress, byte dataVal0,
                                byte dataVal1) {
+  tracer::trace(tracer::Event::CHARGER_REGISTER_WRITE,
+                (uint32_t(regAddress) << 16) | (uint32_t(dataVal1) << 8) |
+                    dataVal0);
+  i2c::Lock lock;
   Wire.beginTransmission(BQ25703Aaddr);
   if (!Wire.write(regAddress)) return false;
   if (!Wire.write(dataVal0)) return false;
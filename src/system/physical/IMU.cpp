@@ -1,5 +1,7 @@
 #include "IMU.h"
 
+#include <atomic>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 
@@ -14,6 +16,9 @@ LSM6DS3 IMU(I2C_MODE, 0x6A);  // I2C device address 0x6A
 static uint32_t lastIMUFunctionCall = 0;
 bool isStarted = false;
 
+// last die temperature, read by the thermal controller from another thread
+static std::atomic<float> temperature_c(NAN);
+
 void enable() {
   lastIMUFunctionCall = millis();
   if (isStarted) {
@@ -36,6 +41,7 @@ void disable() {
 
   digitalWrite(PIN_LSM6DS3TR_C_POWER, LOW);
   isStarted = false;
+  temperature_c.store(NAN);
 }
 
 void disable_after_non_use() {
@@ -45,6 +51,16 @@ void disable_after_non_use() {
   }
 }
 
+void update_temperature() {
+  // do not power the imu only for this reading
+  if (!isStarted) {
+    return;
+  }
+  temperature_c.store(IMU.readTempC());
+}
+
+float get_temperature() { return temperature_c.load(); }
+
 struct vec3d {
   float x;
   float y;
@@ -13,6 +13,14 @@ extern void disable();
 // disable imu if last use is old
 extern void disable_after_non_use();
 
+// read the die temperature, if the imu is powered. Call from the thread that
+// uses the imu
+extern void update_temperature();
+
+// last die temperature of the imu (degrees), NAN if the imu is disabled. Safe
+// from any thread
+extern float get_temperature();
+
 }  // namespace imu
 
 #endif
\ No newline at end of file
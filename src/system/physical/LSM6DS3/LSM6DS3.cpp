@@ -34,8 +34,18 @@ techsupport@sparkfun.com.
 #include "Wire.h"
 #include "stdint.h"
 
+#include "../i2c.h"
+
 #ifdef TARGET_LAMPDA_NRF52840
 #define Wire Wire1
+// own bus, used by a single thread: no lock
+class ImuBusLock {
+ public:
+  ImuBusLock() {}
+};
+#else
+// bus shared with the charger and the PD controller
+using ImuBusLock = i2c::Lock;
 #endif
 //****************************************************************************//
 //
@@ -161,7 +171,8 @@ status_t LSM6DS3Core::readRegisterRegion(uint8_t* outputPointer, uint8_t offset,
   uint8_t tempFFCounter = 0;
 
   switch (commInterface) {
-    case I2C_MODE:
+    case I2C_MODE: {
+      ImuBusLock lock;
       Wire.beginTransmission(I2CAddress);
       Wire.write(offset);
       if (Wire.endTransmission() != 0) {
@@ -178,6 +189,7 @@ status_t LSM6DS3Core::readRegisterRegion(uint8_t* outputPointer, uint8_t offset,
         }
       }
       break;
+    }
 
     case SPI_MODE:
 #ifndef TARGET_LAMPDA_NRF52840
@@ -227,7 +239,8 @@ status_t LSM6DS3Core::readRegister(uint8_t* outputPointer, uint8_t offset) {
   status_t returnError = IMU_SUCCESS;
 
   switch (commInterface) {
-    case I2C_MODE:
+    case I2C_MODE: {
+      ImuBusLock lock;
       Wire.beginTransmission(I2CAddress);
       Wire.write(offset);
       if (Wire.endTransmission() != 0) {
@@ -238,6 +251,7 @@ status_t LSM6DS3Core::readRegister(uint8_t* outputPointer, uint8_t offset) {
         result = Wire.read();     // receive a byte as a proper uint8_t
       }
       break;
+    }
 
     case SPI_MODE:
 #ifndef TARGET_LAMPDA_NRF52840
@@ -297,8 +311,9 @@ status_t LSM6DS3Core::readRegisterInt16(int16_t* outputPointer,
 status_t LSM6DS3Core::writeRegister(uint8_t offset, uint8_t dataToWrite) {
   status_t returnError = IMU_SUCCESS;
   switch (commInterface) {
-    case I2C_MODE:
+    case I2C_MODE: {
       // Write the byte
+      ImuBusLock lock;
       Wire.beginTransmission(I2CAddress);
       Wire.write(offset);
       Wire.write(dataToWrite);
@@ -306,6 +321,7 @@ status_t LSM6DS3Core::writeRegister(uint8_t offset, uint8_t dataToWrite) {
         returnError = IMU_HW_ERROR;
       }
       break;
+    }
 
     case SPI_MODE:
 #ifndef TARGET_LAMPDA_NRF52840
@@ -7,15 +7,29 @@
 
 #include "../ext/noise.h"
 #include "../ext/random8.h"
+#include "../scheduler.h"
+#include "../utils/ring_buffer.h"
+#include "../utils/tracer.h"
 #include "../utils/constants.h"
 #include "fft.h"
 
 namespace microphone {
 
-// buffer to read samples into, each sample is 16-bits
-constexpr size_t sampleSize = 512;  // samplesFFT;
-int16_t _sampleBuffer[sampleSize];
-volatile int samplesRead;
+// size of the PDM buffer (bytes), each sample is 16-bits
+constexpr size_t pdmBufferSize = 512;
+constexpr size_t sampleSize = pdmBufferSize / sizeof(int16_t);
+
+// a PDM buffer of samples
+struct SampleBlock {
+  uint32_t time;  // micros at reception
+  uint16_t count;
+  int16_t samples[sampleSize];
+};
+
+// blocks read by the interrupt, processed by the user loop
+static utils::RingBuffer<SampleBlock, 4> sampleBlocks;
+// the PDM buffer must be read, even with no free block
+static SampleBlock droppedBlock;
 
 uint32_t lastMeasurmentMicros;
 uint32_t lastMeasurmentDurationMicros;
@@ -24,13 +38,29 @@ void on_PDM_data() {
   lastMeasurmentDurationMicros = newTime - lastMeasurmentMicros;
   lastMeasurmentMicros = newTime;
   // query the number of bytes available
-  const int bytesAvailable = PDM.available();
-
-  // read into the sample buffer
-  PDM.read((char*)&_sampleBuffer[0], bytesAvailable);
+  const int bytesAvailable = min(PDM.available(), (int)pdmBufferSize);
 
+  // read into a free block
+  SampleBlock* block = sampleBlocks.begin_push();
+  SampleBlock* destination = (block != nullptr) ? block : &droppedBlock;
+  PDM.read((char*)&destination->samples[0], bytesAvailable);
+  destination->time = newTime;
   // number of samples read
-  samplesRead = bytesAvailable / 2;
+  destination->count = bytesAvailable / 2;
+
+  if (block != nullptr) {
+    sampleBlocks.end_push();
+    // new samples to process in the user loop
+    scheduler::wake_from_isr(scheduler::Task::USER);
+  }
+}
+
+// newest block of samples, nullptr when none was received since the last
+// processFFT
+static const SampleBlock* get_newest_block() {
+  // the older blocks are outdated
+  while (sampleBlocks.size() > 1) sampleBlocks.pop_front();
+  return sampleBlocks.front();
 }
 
 static uint32_t lastMicFunctionCall = 0;
@@ -44,7 +74,10 @@ void enable() {
 
   digitalWrite(PIN_PDM_PWR, HIGH);
 
-  PDM.setBufferSize(512);
+  // drop the samples of the last use
+  sampleBlocks.clear();
+
+  PDM.setBufferSize(pdmBufferSize);
   PDM.onReceive(on_PDM_data);
 
   // initialize PDM with:
@@ -106,13 +139,14 @@ float get_sound_level_Db() {
 
   static float lastValue = 0;
 
-  if (!samplesRead) return lastValue;
+  const SampleBlock* block = get_newest_block();
+  if (block == nullptr or block->count == 0) return lastValue;
 
   float sumOfAll = 0.0;
-  for (int i = 0; i < samplesRead; i++) {
-    sumOfAll += powf(_sampleBuffer[i] / (float)1024.0, 2.0);
+  for (int i = 0; i < block->count; i++) {
+    sumOfAll += powf(block->samples[i] / (float)1024.0, 2.0);
   }
-  const float average = sumOfAll / (float)samplesRead;
+  const float average = sumOfAll / (float)block->count;
 
   lastValue = 20.0 * log10f(sqrtf(average));
   // convert to decibels
@@ -122,14 +156,16 @@ float get_sound_level_Db() {
 bool processFFT(const bool runFFT = true) {
   enable();
 
-  if (samplesRead <= 0) {
+  const SampleBlock* block = get_newest_block();
+  if (block == nullptr) {
     return false;
   }
+  const int samplesRead = block->count;
 
   // get data
   uint32_t userloopDelay = LOOP_UPDATE_PERIOD;
   for (int i = 0; i < samplesRead; i++) {
-    float sample = (_sampleBuffer[i] & 0xFFFF);
+    float sample = (block->samples[i] & 0xFFFF);
 
     processSample(sample);
     agcAvg();
@@ -151,8 +187,13 @@ bool processFFT(const bool runFFT = true) {
   limitSampleDynamics();
   autoResetPeak();
 
-  samplesRead = 0;
-  if (runFFT) FFTcode();
+  // release the block
+  sampleBlocks.pop_front();
+  if (runFFT) {
+    tracer::trace(tracer::Event::FFT_BEGIN, samplesRead);
+    FFTcode();
+    tracer::trace(tracer::Event::FFT_END);
+  }
 
   return true;
 }
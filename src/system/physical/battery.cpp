@@ -1,62 +1,278 @@
 #include "battery.h"
 
+#include <atomic>
+#include <cmath>
+
 #include "../alerts.h"
+#include "../charger/charger.h"
 #include "../utils/constants.h"
+#include "../utils/soc.h"
 #include "../utils/utils.h"
+#include "led_power.h"
+#include "saadc.h"
 
 namespace battery {
 
-// return a number between 0 and 100
-uint8_t get_battery_level(const bool resetRead) {
-  constexpr float maxVoltage = 4.2 * 4;
-  constexpr float lowVoltage = 3.1 * 4;
+static constexpr float maxVoltage = 4.2 * 4;
+static constexpr float lowVoltage = 3.1 * 4;
+
+// 3v internal ref, ADC resolution
+static constexpr uint16_t minInValue =
+    lowVoltage * voltageDividerCoeff * ADC_MAX_VALUE / internalReferenceVoltage;
+static constexpr uint16_t maxInValue =
+    maxVoltage * voltageDividerCoeff * ADC_MAX_VALUE / internalReferenceVoltage;
+
+// low pass filter time constant, the one of the previous filter updated at
+// every loop
+static constexpr float filterTimeConstant_s = 2.0;
 
-  static float lastValue = 0;
+static SoftwareTimer samplerTimer;
 
-  // 3v internal ref, ADC resolution
-  static constexpr uint16_t minInValue = lowVoltage * voltageDividerCoeff *
-                                         ADC_MAX_VALUE /
-                                         internalReferenceVoltage;
-  static constexpr uint16_t maxInValue = maxVoltage * voltageDividerCoeff *
-                                         ADC_MAX_VALUE /
-                                         internalReferenceVoltage;
-  const uint16_t pinRead = analogRead(BAT21);
+// published snapshot, with a sequence lock: odd sequence while writing.
+// The sampler task is the only writer.
+static Snapshot snapshot = {0, 0, 0.0, 0.0, 0.0, 0.0, false};
+static std::atomic<uint32_t> snapshotSequence{0};
+// the next sample restarts the filter
+static std::atomic<bool> shouldResetFilter{false};
+
+static void publish(const Snapshot& newSnapshot) {
+  const uint32_t sequence = snapshotSequence.load(std::memory_order_relaxed);
+  snapshotSequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  snapshot = newSnapshot;
+  snapshotSequence.store(sequence + 2, std::memory_order_release);
+}
+
+Snapshot get_snapshot() {
+  Snapshot copy;
+  uint32_t sequence;
+  do {
+    sequence = snapshotSequence.load(std::memory_order_acquire);
+    copy = snapshot;
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((sequence & 1) != 0 or
+           sequence != snapshotSequence.load(std::memory_order_relaxed));
+  return copy;
+}
+
+// internal resistance learning, from the voltage steps of the led current
+static constexpr float initialResistance_ohm = 0.15;  // 4 cells and wiring
+static constexpr float minResistance_ohm = 0.02;
+static constexpr float maxResistance_ohm = 1.0;
+static constexpr float minLedCurrentStep_A = 0.2;
+static constexpr float resistanceLearningRate = 0.2;
+static constexpr float driverEfficiency = 0.9;
+
+static std::atomic<float> internalResistance_ohm{initialResistance_ohm};
+
+float get_internal_resistance() { return internalResistance_ohm.load(); }
+
+// battery current drawn by the led driver
+static float get_load_current(const float ledCurrent_A, const float voltage) {
+  return ledCurrent_A * inputVoltage_V / (voltage * driverEfficiency);
+}
+
+/**
+ * \brief Measure the voltage step between two samples taken at a steady led
+ * current. The measure is kept if the current is still the same at the next
+ * sample (not a ramp)
+ */
+static void learn_internal_resistance(const uint32_t time, const float voltage,
+                                      const float ledCurrent_A) {
+  static bool hasPrevious = false;
+  static bool isPreviousSteady = false;
+  static uint32_t previousTime = 0;
+  static float previousVoltage = 0.0;
+  static float previousLedCurrent_A = 0.0;
+  static bool isStepPending = false;
+  static float stepResistance_ohm = 0.0;
+
+  // the charger powers the leds: no battery voltage step
+  const bool isValid = hasPrevious and not charger::is_powered_on() and
+                       time - previousTime <= 2 * samplePeriod_ms;
+  const bool isSteady = isValid and ledCurrent_A == previousLedCurrent_A;
+
+  if (isStepPending and isSteady) {
+    float resistance = internalResistance_ohm.load();
+    resistance += resistanceLearningRate * (stepResistance_ohm - resistance);
+    internalResistance_ohm.store(resistance);
+  }
+  isStepPending = false;
+
+  if (isValid and isPreviousSteady and
+      fabsf(ledCurrent_A - previousLedCurrent_A) >= minLedCurrentStep_A) {
+    const float currentStep_A = get_load_current(ledCurrent_A, voltage) -
+                                get_load_current(previousLedCurrent_A,
+                                                 previousVoltage);
+    stepResistance_ohm = (previousVoltage - voltage) / currentStep_A;
+    isStepPending = stepResistance_ohm >= minResistance_ohm and
+                    stepResistance_ohm <= maxResistance_ohm;
+  }
+
+  hasPrevious = true;
+  isPreviousSteady = isSteady;
+  previousTime = time;
+  previousVoltage = voltage;
+  previousLedCurrent_A = ledCurrent_A;
+}
+
+// filter and publish a new sample
+static void process_sample(const uint32_t time, const uint16_t raw,
+                           const float ledCurrent_A) {
+  Snapshot newSnapshot = snapshot;  // only this task writes it
+  newSnapshot.raw = raw;
 
   // in bounds with some margin
-  if (pinRead < minInValue * 0.95 or pinRead > maxInValue * 1.05) {
+  newSnapshot.isCoherent =
+      raw >= minInValue * 0.95 and raw <= maxInValue * 1.05;
+  if (newSnapshot.isCoherent) {
+    AlertManager.clear_alert(Alerts::BATTERY_READINGS_INCOHERENT);
+
+    newSnapshot.voltage = utils::analogToDividerVoltage(raw);
+    learn_internal_resistance(time, newSnapshot.voltage, ledCurrent_A);
+
+    // on USB power, the charger supplies the leds
+    const float loadCurrent_A =
+        charger::is_powered_on()
+            ? 0.0
+            : get_load_current(ledCurrent_A, newSnapshot.voltage);
+
+    if (newSnapshot.time == 0 or newSnapshot.filteredVoltage == 0.0 or
+        shouldResetFilter.exchange(false)) {
+      // init or reset
+      newSnapshot.filteredVoltage = newSnapshot.voltage;
+      newSnapshot.loadCurrent_A = loadCurrent_A;
+    } else {
+      // filter on the elapsed time, not on the number of samples: same
+      // response whatever the sampling period.
+      // Same filter on the current, so it matches the filtered voltage
+      const float elapsed_s = (time - newSnapshot.time) / 1000.0;
+      const float filterValue = 1.0 - expf(-elapsed_s / filterTimeConstant_s);
+      newSnapshot.filteredVoltage +=
+          filterValue * (newSnapshot.voltage - newSnapshot.filteredVoltage);
+      newSnapshot.loadCurrent_A +=
+          filterValue * (loadCurrent_A - newSnapshot.loadCurrent_A);
+    }
+
+    // remove the voltage drop of the load
+    newSnapshot.openCircuitVoltage =
+        newSnapshot.filteredVoltage +
+        newSnapshot.loadCurrent_A * internalResistance_ohm.load();
+  } else {
     AlertManager.raise_alert(Alerts::BATTERY_READINGS_INCOHERENT);
-    return 0;
   }
-  AlertManager.clear_alert(Alerts::BATTERY_READINGS_INCOHERENT);
 
-  const float batteryVoltage = utils::analogToDividerVoltage(pinRead);
+  newSnapshot.time = time;
+  publish(newSnapshot);
+}
+
+// start time of the conversion in progress, and led current at this time
+static uint32_t conversionTime = 0;
+static float conversionLedCurrent_A = 0.0;
 
-  // init or reset
-  if (lastValue == 0 or resetRead) {
-    lastValue = batteryVoltage;
+static void start_conversion() {
+  conversionTime = millis();
+  conversionLedCurrent_A = ledpower::get_output_current();
+  saadc::start_conversion();
+}
+
+// collect the last conversion and start the next one (timer task)
+static void sample_step(TimerHandle_t) {
+  uint16_t raw;
+  if (saadc::read_conversion(raw)) {
+    process_sample(conversionTime, raw, conversionLedCurrent_A);
   }
+  start_conversion();
+}
 
-  // average on 1 second
-  static constexpr float filterValue = (float)LOOP_UPDATE_PERIOD / 2000.0;
-  lastValue += filterValue * (batteryVoltage - lastValue);
-
-  const float rawBatteryLevel = constrain(
-      utils::map(lastValue, lowVoltage, maxVoltage, 0.0, 100.0), 0.0, 100.0);
-
-  uint8_t batteryLevel = 0.0;
-  // remap to match the reality
-  if (rawBatteryLevel < 40.0) {
-    // fast drop for the last half of the battery
-    batteryLevel = utils::map(rawBatteryLevel, 0.0, 40.0, 0.0, 12.0);
-  } else if (rawBatteryLevel < 90.0) {
-    // most of the battery level is here, slow slope
-    batteryLevel = utils::map(rawBatteryLevel, 40.0, 90.0, 12.0, 95.0);
-  } else {
-    // battery level > 90
-    batteryLevel = utils::map(rawBatteryLevel, 90.0, 100.0, 95.0,
-                              100.0);  // highest 15% -> drop slowly
+void setup() {
+  if (not saadc::setup(BAT21)) return;
+
+  // first sample, so the battery level is valid before the first period
+  start_conversion();
+  uint16_t raw;
+  while (not saadc::read_conversion(raw)) {
+    delayMicroseconds(100);
+  }
+  process_sample(conversionTime, raw, conversionLedCurrent_A);
+
+  start_conversion();
+  samplerTimer.begin(samplePeriod_ms, sample_step);
+  samplerTimer.start();
+}
+
+void set_sample_period(const uint32_t period_ms) {
+  static uint32_t currentPeriod_ms = samplePeriod_ms;
+  if (period_ms == currentPeriod_ms) return;
+  currentPeriod_ms = period_ms;
+  samplerTimer.setPeriod(period_ms);
+}
+
+static soc::Estimator estimator(batteryCapacity_mAh);
+// published estimation, read by the other tasks
+static std::atomic<float> stateOfCharge{NAN};
+static bool isStateOfChargeLogged = false;
+
+void update_state_of_charge(const bool isShutdown) {
+  static constexpr uint32_t updatePeriod_ms = 1000;
+  static uint32_t lastUpdateTime = 0;
+  const uint32_t time = millis();
+  if (lastUpdateTime != 0 and time - lastUpdateTime < updatePeriod_ms) return;
+  lastUpdateTime = time;
+
+  const Snapshot battery = get_snapshot();
+  if (not battery.isCoherent) return;
+
+  // the charger ADC only converts while charging, or when the leds are on
+  int32_t current_mA = 0;
+  if ((not isShutdown or charger::is_charging()) and
+      not charger::get_battery_current(current_mA))
+    return;
+
+  if (isStateOfChargeLogged) {
+    Serial.print("soc:");
+    Serial.print(time);
+    Serial.print(",");
+    Serial.print(current_mA);
+    Serial.print(",");
+    Serial.println(battery.openCircuitVoltage, 3);
+  }
+
+  estimator.update(time, current_mA, battery.openCircuitVoltage);
+  stateOfCharge.store(estimator.get_soc());
+}
+
+void restore_state_of_charge(const float soc) {
+  const Snapshot battery = get_snapshot();
+  if (not battery.isCoherent) return;
+
+  estimator.restore(soc, battery.openCircuitVoltage);
+  stateOfCharge.store(estimator.get_soc());
+}
+
+float get_state_of_charge() { return stateOfCharge.load(); }
+
+void set_state_of_charge_logging(const bool isEnabled) {
+  isStateOfChargeLogged = isEnabled;
+}
+
+// return a number between 0 and 100
+uint8_t get_battery_level(const bool resetRead) {
+  const Snapshot battery = get_snapshot();
+  if (not battery.isCoherent) {
+    return 0;
+  }
+
+  if (resetRead) {
+    shouldResetFilter.store(true);
+  }
+
+  const float soc = stateOfCharge.load();
+  if (not std::isnan(soc)) {
+    return soc;
   }
-  return batteryLevel;
+  // no estimation yet, use the voltage
+  return soc::get_open_circuit_soc(battery.openCircuitVoltage);
 }
 
 // Raise the battery low or battery critical alert
@@ -69,10 +285,21 @@ void raise_battery_alert() {
     lastCall = newCall;
     const uint8_t percent = get_battery_level();
 
+    // voltage floor: the coulomb counting runs high under a steady load (see
+    // soc.h), the pack voltage protects the cells whatever the estimation says
+    static constexpr float cutoffVoltage =
+        soc::cellCutoffVoltage_V * soc::cellCount;
+    static constexpr float cutoffHysteresis = 0.05 * soc::cellCount;
+    const Snapshot battery = get_snapshot();
+    const bool isUnderCutoff =
+        battery.isCoherent and battery.openCircuitVoltage < cutoffVoltage;
+    const bool isOverCutoff =
+        battery.openCircuitVoltage > cutoffVoltage + cutoffHysteresis;
+
     // % battery is critical
-    if (percent <= batteryCritical) {
+    if (percent <= batteryCritical or isUnderCutoff) {
       AlertManager.raise_alert(Alerts::BATTERY_CRITICAL);
-    } else if (percent > batteryCritical + 1) {
+    } else if (percent > batteryCritical + 1 and isOverCutoff) {
       AlertManager.clear_alert(Alerts::BATTERY_CRITICAL);
 
       // % battery is low, start alerting
@@ -5,7 +5,68 @@
 
 namespace battery {
 
+// period of the background battery voltage sampling (ms)
+constexpr uint32_t samplePeriod_ms = 100;
+
+/**
+ * \brief Battery voltage published by the background sampler
+ */
+struct Snapshot {
+  uint32_t time;             // time of the sample (ms), 0 before the first one
+  uint16_t raw;              // oversampled ADC value
+  float voltage;             // battery voltage of this sample
+  float filteredVoltage;     // low pass filtered battery voltage
+  float loadCurrent_A;       // filtered battery current drawn by the leds
+  float openCircuitVoltage;  // filtered voltage, corrected by the load
+  bool isCoherent;           // is the sample in the battery voltage bounds
+};
+
+/**
+ * \brief Configure the SAADC, take a first sample and start the background
+ * sampling, every samplePeriod_ms
+ */
+extern void setup();
+
+/**
+ * \brief Change the background sampling period. The filter is time based, so
+ * the period does not change the filtering
+ */
+extern void set_sample_period(const uint32_t period_ms);
+
+/**
+ * \brief Last published battery voltage, does not access the hardware
+ */
+extern Snapshot get_snapshot();
+
+/**
+ * \brief Internal resistance of the pack (ohms), learned from the voltage
+ * steps caused by the led current changes
+ */
+extern float get_internal_resistance();
+
+/**
+ * \brief Update the state of charge estimation (coulomb counting corrected
+ * with the voltage at rest). Call at every alert update, the estimation is
+ * updated once per second
+ * \param[in] isShutdown is the lamp shut down (no discharge measure)
+ */
+extern void update_state_of_charge(const bool isShutdown);
+
+/**
+ * \brief Restore the persisted state of charge, at startup
+ * \param[in] soc state of charge (%)
+ */
+extern void restore_state_of_charge(const float soc);
+
+// estimated state of charge (%), NAN before the first estimation
+extern float get_state_of_charge();
+
+// print the inputs of the state of charge estimation on serial, to replay them
+// with tools/soc_replay.cpp
+extern void set_state_of_charge_logging(const bool isEnabled);
+
 // return a number between 0 and 100
+// resetRead: use the last sample, and restart the filter from it
 extern uint8_t get_battery_level(const bool resetRead = false);
 
 extern void raise_battery_alert();
@@ -1,14 +1,22 @@
 #include "button.h"
 
+#include "../scheduler.h"
 #include "../utils/constants.h"
+#include "../utils/dither.h"
+#include "../utils/gradient.h"
+#include "../utils/ring_buffer.h"
 #include "../utils/utils.h"
 
 #define RELEASE_TIMING_MS 200
 
 namespace button {
 
-static volatile bool wasButtonPressedDetected = false;
-void button_state_interrupt() { wasButtonPressedDetected = true; }
+// button edges (true when pressed), from the interrupt to the input thread
+static utils::RingBuffer<utils::TimedEvent<bool>, 16> buttonEdges;
+void button_state_interrupt() {
+  buttonEdges.push({millis(), digitalRead(BUTTON_PIN) == LOW});
+  scheduler::wake_from_isr(scheduler::Task::BUTTON);
+}
 
 void init() {
   pinMode(BUTTON_RED, OUTPUT);
@@ -23,11 +31,30 @@ void init() {
                   CHANGE);
 }
 
-static volatile bool buttonPressListener = false;
-void read_while_pressed() {
-  if (wasButtonPressedDetected and digitalRead(BUTTON_PIN) == HIGH) {
-    wasButtonPressedDetected = false;
+static uint32_t lastEventTime = 0;
+uint32_t get_last_event_time() { return lastEventTime; }
+
+// consume the button edges, true if the button was pressed since the last
+// call, even for a press released in between
+bool read_button_edges() {
+  static bool isPressed = false;
+  bool wasPressed = isPressed;
+
+  utils::TimedEvent<bool> edge;
+  while (buttonEdges.pop(edge)) {
+    isPressed = edge.value;
+    wasPressed = wasPressed or isPressed;
+    lastEventTime = edge.time;
   }
+
+  // some edges were dropped (bounces), resync with the pin
+  static uint32_t droppedCount = 0;
+  if (buttonEdges.get_dropped_count() != droppedCount) {
+    droppedCount = buttonEdges.get_dropped_count();
+    isPressed = digitalRead(BUTTON_PIN) == LOW;
+    wasPressed = wasPressed or isPressed;
+  }
+  return wasPressed;
 }
 
 void treat_button_pressed(
@@ -88,14 +115,35 @@ void treat_button_pressed(
 void handle_events(
     const std::function<void(uint8_t)>& clickSerieCallback,
     const std::function<void(uint8_t, uint32_t)>& clickHoldSerieCallback) {
-  // keep reading the button value until unpressed
-  read_while_pressed();
-
   // check the button pressed status
-  treat_button_pressed(wasButtonPressedDetected, clickSerieCallback,
+  treat_button_pressed(read_button_edges(), clickSerieCallback,
                        clickHoldSerieCallback);
 }
 
+// the button channels are dithered, to display the dim colors properly
+static utils::Dither8 redDither;
+static utils::Dither8 greenDither;
+static utils::Dither8 blueDither;
+// set by the frame period (charge idle displays a frame by second)
+static bool isDithered = true;
+
+static void write_color() {
+  if (isDithered) {
+    analogWrite(BUTTON_RED, redDither.next());
+    analogWrite(BUTTON_GREEN, greenDither.next());
+    analogWrite(BUTTON_BLUE, blueDither.next());
+  } else {
+    analogWrite(BUTTON_RED, redDither.get_rounded());
+    analogWrite(BUTTON_GREEN, greenDither.get_rounded());
+    analogWrite(BUTTON_BLUE, blueDither.get_rounded());
+  }
+}
+
+void update(const uint32_t framePeriod_ms) {
+  isDithered = framePeriod_ms <= maxDitherPeriod_ms;
+  write_color();
+}
+
 void set_color(utils::ColorSpace::RGB color) {
   static constexpr float redColorCorrection = 1.0;
   static constexpr float greenColorCorrection =
@@ -103,10 +151,12 @@ void set_color(utils::ColorSpace::RGB color) {
       7.5;  // the green of this button is way way higher than the other colors
   static constexpr float blueColorCorrection = 1.0;
 
+  // 16 bits levels (x * 257 maps 255 to UINT16_MAX)
   const COLOR& col = color.get_rgb();
-  analogWrite(BUTTON_RED, col.red * redColorCorrection);
-  analogWrite(BUTTON_GREEN, col.green * greenColorCorrection);
-  analogWrite(BUTTON_BLUE, col.blue * blueColorCorrection);
+  redDither.set_target(col.red * 257 * redColorCorrection);
+  greenDither.set_target(col.green * 257 * greenColorCorrection);
+  blueDither.set_target(col.blue * 257 * blueColorCorrection);
+  write_color();
 }
 
 void blink(const uint offFreq, const uint onFreq,
@@ -135,6 +185,10 @@ void breeze(const uint32_t periodOn, const uint32_t periodOff,
   const uint32_t time = millis();
   static uint32_t startTime = time;
 
+  // black to color, only recomputed when the color changes
+  static utils::Gradient<32> breezeGradient;
+  breezeGradient.set_stops({0, color.get_rgb().color});
+
   // breeze on
   if (time - startTime < periodOn) {
     float progression = (time - startTime) / (float)periodOn;
@@ -143,16 +197,16 @@ void breeze(const uint32_t periodOn, const uint32_t periodOff,
     if (progression < 0.5) {
       progression /= 0.5;
 
-      set_color(utils::ColorSpace::RGB(
-          utils::get_gradient(0, color.get_rgb().color, progression)));
+      set_color(
+          utils::ColorSpace::RGB(breezeGradient.get_color(progression)));
     }
     // falling edge
     else {
       progression = 1.0 - progression;
       progression /= 0.5;
 
-      set_color(utils::ColorSpace::RGB(
-          utils::get_gradient(0, color.get_rgb().color, progression)));
+      set_color(
+          utils::ColorSpace::RGB(breezeGradient.get_color(progression)));
     }
   }
   // breeze of
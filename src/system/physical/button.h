@@ -10,6 +10,9 @@ namespace button {
 
 #define HOLD_BUTTON_MIN_MS 500  // press and hold delay (ms)
 
+// longest display frame period with a dithered button color (ms)
+constexpr uint32_t maxDitherPeriod_ms = 20;
+
 void init();
 
 /**
@@ -25,10 +28,22 @@ void handle_events(
     const std::function<void(uint8_t)>& clickSerieCallback,
     const std::function<void(uint8_t, uint32_t)>& clickHoldSerieCallback);
 
+// time of the last button press or release (millis)
+uint32_t get_last_event_time();
+
 /**
  * Display a color on the button
  */
 void set_color(utils::ColorSpace::RGB color);
+
+/**
+ * \brief Output the next frame of the button color, call once per display
+ * frame
+ * \param[in] framePeriod_ms period of the display frames. The color is only
+ * dithered up to maxDitherPeriod_ms: slower, the dithering is seen as a
+ * flicker
+ */
+void update(const uint32_t framePeriod_ms);
 void blink(const uint offFreq, const uint onFreq, utils::ColorSpace::RGB color);
 
 /**
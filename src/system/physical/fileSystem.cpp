@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "../utils/constants.h"
+#include "../utils/tracer.h"
 
 namespace fileSystem {
 
@@ -78,6 +79,8 @@ void write_state() {
     setup();
   }
 
+  tracer::trace(tracer::Event::FILE_WRITE_BEGIN, _valueMap.size());
+
   // hardcore, format the entire file system
   // InternalFS.format();
 
@@ -92,6 +95,8 @@ void write_state() {
     file.printf("%s:%d\n", keyval.first.c_str(), keyval.second);
   }
   file.close();
+
+  tracer::trace(tracer::Event::FILE_WRITE_END);
 }
 
 bool get_value(const std::string& key, uint32_t& value) {
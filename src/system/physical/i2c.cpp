@@ -0,0 +1,21 @@
+#include "i2c.h"
+
+#include <Arduino.h>
+
+namespace i2c {
+
+static SemaphoreHandle_t busMutex = nullptr;
+
+void setup() {
+  if (busMutex == nullptr) busMutex = xSemaphoreCreateMutex();
+}
+
+void lock() {
+  if (busMutex != nullptr) xSemaphoreTake(busMutex, portMAX_DELAY);
+}
+
+void unlock() {
+  if (busMutex != nullptr) xSemaphoreGive(busMutex);
+}
+
+}  // namespace i2c
@@ -0,0 +1,31 @@
+#ifndef I2C_H
+#define I2C_H
+
+/// Mutual exclusion on the i2c bus (Wire), shared by the charger and the PD
+/// controller, that run in different threads. The IMU takes it only when it
+/// is on the same bus: on TARGET_LAMPDA_NRF52840 it has its own bus (Wire1),
+/// only used by the animation thread.
+namespace i2c {
+
+// create the bus mutex, before the threads start
+void setup();
+
+// take and give the bus, no effect before setup
+void lock();
+void unlock();
+
+/**
+ * \brief Hold the bus in the enclosing scope
+ */
+class Lock {
+ public:
+  Lock() { lock(); }
+  ~Lock() { unlock(); }
+
+  Lock(const Lock&) = delete;
+  Lock& operator=(const Lock&) = delete;
+};
+
+}  // namespace i2c
+
+#endif
@@ -1,33 +1,110 @@
 #include "led_power.h"
 
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 
+#include "../charger/charger.h"
 #include "../utils/constants.h"
 #include "../utils/utils.h"
+#include "pwm.h"
 
 namespace ledpower {
 
+// current asked by the last write_current call (animation thread)
+static std::atomic<float> requestedCurrent_A{0.0};
+// led current scaling, set by the current limiter (power thread)
+static std::atomic<float> limiterScale{1.0};
+// current set on the driver, read by the battery sampler
+static std::atomic<float> outputCurrent_A{0.0};
+
+// Called by both writers. Each one writes the driver from a snapshot of the
+// two values, then checks that they did not change in the meantime: the last
+// driver write always uses the latest values
+static void apply_current() {
+  float requested = requestedCurrent_A.load();
+  float scale = limiterScale.load();
+  while (true) {
+    const float current_A = requested * scale;
+    outputCurrent_A.store(current_A);
+
+    // map current value to a 16 bits driver value
+    const uint16_t mappedDriverValue =
+        utils::map(current_A, 0, maxPowerConsumption_A, 0, UINT16_MAX);
+
+    pwm::write_brightness(mappedDriverValue);
+
+    const float newRequested = requestedCurrent_A.load();
+    const float newScale = limiterScale.load();
+    if (newRequested == requested and newScale == scale) return;
+    requested = newRequested;
+    scale = newScale;
+  }
+}
+
 /**
  * Power on the current driver with a specific current value
  */
 void write_current(const float current) {
-  float currentCurrent = constrain(current, 0, maxPowerConsumption_A);
+  requestedCurrent_A.store(constrain(current, 0, maxPowerConsumption_A));
+  apply_current();
+}
+
+void update_current_limiter() {
+  static constexpr uint32_t samplePeriod_ms = 100;
+  // the scale goes back to 1 in 5 seconds
+  static constexpr float releaseStep = samplePeriod_ms / 5000.0;
+  // no release above this load, to avoid oscillating around the budget
+  static constexpr float releaseThreshold = 0.9;
+  static constexpr float minScale = 0.1;
 
-  // map current value to driver value
-  const uint8_t mappedDriverValue =
-      utils::map(currentCurrent, 0, maxPowerConsumption_A, 0, 255);
+  static uint32_t lastSampleTime = 0;
+  const uint32_t time = millis();
+  if (time - lastSampleTime < samplePeriod_ms) return;
+  lastSampleTime = time;
 
-  analogWrite(OUT_BRIGHTNESS, mappedDriverValue);
+  uint16_t dischargeCurrent_mA = 0;
+  float systemPower_W = 0;
+  if (not charger::get_discharge_measures(dischargeCurrent_mA, systemPower_W))
+    return;
+
+  // ratio of the power budget in use
+  const float load = max(dischargeCurrent_mA / float(maxDischargeCurrent_mA),
+                         systemPower_W / maxSystemPower_W);
+
+  // only this function writes the scale
+  const float scale = limiterScale.load();
+  float newScale = scale;
+  if (load > 1.0) {
+    // fast attack: the leds are the main load, scale them to fit the budget
+    newScale = max(minScale, scale / load);
+  } else if (load < releaseThreshold) {
+    // slow release
+    newScale = min(1.0f, scale + releaseStep);
+  }
+
+  if (newScale != scale) {
+    limiterScale.store(newScale);
+    apply_current();
+  }
 }
 
+float get_current_limiter_scale() { return limiterScale.load(); }
+
+float get_output_current() { return outputCurrent_A.load(); }
+
 /**
  * Power on the current driver with a soecific brightness value
  */
-void write_brightness(const uint8_t brightness) {  // map to current value
+void write_brightness(const uint8_t brightness) {
+  // 255 * 257 = UINT16_MAX
+  write_brightness16(brightness * 257);
+}
+
+void write_brightness16(const uint16_t brightness) {  // map to current value
   const float brightnessToCurrent =
-      utils::map(brightness, 0, 255, 0, maxStripConsumption_A);
+      utils::map(brightness, 0, UINT16_MAX, 0, maxStripConsumption_A);
   write_current(brightnessToCurrent);
 }
 
-}  // namespace ledpower
\ No newline at end of file
+}  // namespace ledpower
@@ -6,6 +6,7 @@
 namespace ledpower {
 
 /** Write a current value directly to the led strip (DANGEROUS)
+ * The driver output has a resolution of pwm::brightnessResolution bits
  * \param[in] current target current, from 0 (off) to maxPowerConsumption_A
  */
 extern void write_current(const float current);
@@ -17,6 +18,29 @@ extern void write_current(const float current);
  */
 extern void write_brightness(const uint8_t brightness);
 
+/** \brief Write a brightness relative to the led strip used, with a 16 bits
+ * resolution
+ * \param[in] brightness: 0 to UINT16_MAX value, that will be converted to a 0
+ * (off) to maxStripConsumption_A
+ */
+extern void write_brightness16(const uint16_t brightness);
+
+/**
+ * \brief Closed loop current limiter, call at every loop.
+ * Samples the battery discharge current and system power every 100ms, and
+ * scales down the led current to keep the system under maxDischargeCurrent_mA
+ * and maxSystemPower_W. Can run in another task than the write calls, always
+ * the same one
+ */
+extern void update_current_limiter();
+
+// scale applied to the led current by the limiter, from 0.1 to 1
+extern float get_current_limiter_scale();
+
+// led current set on the driver (A), after the limiter. Safe to call from
+// any task
+extern float get_output_current();
+
 }  // namespace ledpower
 
 #endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "pwm.h"
+
+#include <Arduino.h>
+
+namespace pwm {
+
+// PWM peripheral reserved to the led driver, analogWrite uses the others
+static HardwarePWM& brightnessPwm = HwPWM3;
+// identify this module as the owner of the PWM peripheral
+static const uint32_t ownershipToken = 0x4C504F57;  // "LPOW"
+
+// configure the PWM on the first use
+static bool init() {
+  static bool isInitialized = false;
+  if (isInitialized) return true;
+
+  if (not brightnessPwm.takeOwnership(ownershipToken)) return false;
+
+  brightnessPwm.setClockDiv(PWM_PRESCALER_PRESCALER_DIV_1);  // 16MHz
+  brightnessPwm.setResolution(brightnessResolution);
+  brightnessPwm.addPin(OUT_BRIGHTNESS);
+  brightnessPwm.begin();
+
+  isInitialized = true;
+  return true;
+}
+
+void write_brightness(const uint16_t duty) {
+  if (not init()) return;
+
+  brightnessPwm.writePin(OUT_BRIGHTNESS, duty >> (16 - brightnessResolution));
+}
+
+}  // namespace pwm
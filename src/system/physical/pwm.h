@@ -0,0 +1,25 @@
+#ifndef PWM_H
+#define PWM_H
+
+#include <cstdint>
+
+/// Hardware abstraction of the high resolution led driver PWM.
+/// pwm.cpp implements it with the nRF52 PWM peripheral, a host build can link
+/// another implementation to record the duty cycles.
+namespace pwm {
+
+// resolution of the brightness output, in bits (about 1kHz at 16MHz)
+constexpr uint8_t brightnessResolution = 14;
+
+/**
+ * \brief Set the duty cycle of the led driver brightness output
+ * The value is loaded in the PWM sequence, played by EasyDMA without any CPU
+ * involvement
+ * \param[in] duty 0 (off) to UINT16_MAX (always on), truncated to
+ * brightnessResolution bits
+ */
+void write_brightness(const uint16_t duty);
+
+}  // namespace pwm
+
+#endif
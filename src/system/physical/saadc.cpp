@@ -0,0 +1,108 @@
+#include "saadc.h"
+
+#include <Arduino.h>
+
+#include "../utils/constants.h"
+
+namespace saadc {
+
+// EasyDMA destination of the conversions
+static volatile int16_t result = 0;
+static bool isConversionStarted = false;
+
+// SAADC analog input of an arduino pin (nRF52840 fixed mapping)
+static uint32_t get_analog_input(const uint32_t pin) {
+  switch (g_ADigitalPinMap[pin]) {
+    case 2:
+      return SAADC_CH_PSELP_PSELP_AnalogInput0;
+    case 3:
+      return SAADC_CH_PSELP_PSELP_AnalogInput1;
+    case 4:
+      return SAADC_CH_PSELP_PSELP_AnalogInput2;
+    case 5:
+      return SAADC_CH_PSELP_PSELP_AnalogInput3;
+    case 28:
+      return SAADC_CH_PSELP_PSELP_AnalogInput4;
+    case 29:
+      return SAADC_CH_PSELP_PSELP_AnalogInput5;
+    case 30:
+      return SAADC_CH_PSELP_PSELP_AnalogInput6;
+    case 31:
+      return SAADC_CH_PSELP_PSELP_AnalogInput7;
+    default:
+      return SAADC_CH_PSELP_PSELP_NC;
+  }
+}
+
+static constexpr uint32_t get_resolution() {
+  return ADC_RES_EXP == 8    ? SAADC_RESOLUTION_VAL_8bit
+         : ADC_RES_EXP == 10 ? SAADC_RESOLUTION_VAL_10bit
+         : ADC_RES_EXP == 12 ? SAADC_RESOLUTION_VAL_12bit
+                             : SAADC_RESOLUTION_VAL_14bit;
+}
+
+bool setup(const uint32_t pin) {
+  const uint32_t analogInput = get_analog_input(pin);
+  if (analogInput == SAADC_CH_PSELP_PSELP_NC) return false;
+
+  NRF_SAADC->ENABLE = SAADC_ENABLE_ENABLE_Disabled;
+
+  NRF_SAADC->RESOLUTION = get_resolution();
+  NRF_SAADC->OVERSAMPLE = oversamplingExp;
+  // conversions are triggered by the sample task
+  NRF_SAADC->SAMPLERATE = SAADC_SAMPLERATE_MODE_Task
+                          << SAADC_SAMPLERATE_MODE_Pos;
+
+  // 0.6V internal reference with a 1/5 gain: 3V range.
+  // Burst mode: a single sample task runs all the oversampling.
+  // 40us acquisition, for the high impedance of the battery voltage divider
+  NRF_SAADC->CH[0].CONFIG =
+      (SAADC_CH_CONFIG_RESP_Bypass << SAADC_CH_CONFIG_RESP_Pos) |
+      (SAADC_CH_CONFIG_RESN_Bypass << SAADC_CH_CONFIG_RESN_Pos) |
+      (SAADC_CH_CONFIG_GAIN_Gain1_5 << SAADC_CH_CONFIG_GAIN_Pos) |
+      (SAADC_CH_CONFIG_REFSEL_Internal << SAADC_CH_CONFIG_REFSEL_Pos) |
+      (SAADC_CH_CONFIG_TACQ_40us << SAADC_CH_CONFIG_TACQ_Pos) |
+      (SAADC_CH_CONFIG_MODE_SE << SAADC_CH_CONFIG_MODE_Pos) |
+      (SAADC_CH_CONFIG_BURST_Enabled << SAADC_CH_CONFIG_BURST_Pos);
+  NRF_SAADC->CH[0].PSELN = SAADC_CH_PSELN_PSELN_NC;
+  NRF_SAADC->CH[0].PSELP = analogInput;
+
+  NRF_SAADC->RESULT.PTR =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&result));
+  NRF_SAADC->RESULT.MAXCNT = 1;
+
+  NRF_SAADC->ENABLE = SAADC_ENABLE_ENABLE_Enabled;
+
+  // offset calibration, takes a few hundred microseconds
+  NRF_SAADC->EVENTS_CALIBRATEDONE = 0;
+  NRF_SAADC->TASKS_CALIBRATEOFFSET = 1;
+  while (NRF_SAADC->EVENTS_CALIBRATEDONE == 0) {
+  }
+
+  isConversionStarted = false;
+  return true;
+}
+
+void start_conversion() {
+  NRF_SAADC->EVENTS_STARTED = 0;
+  NRF_SAADC->EVENTS_END = 0;
+  // arm EasyDMA, then sample
+  NRF_SAADC->TASKS_START = 1;
+  while (NRF_SAADC->EVENTS_STARTED == 0) {
+  }
+  NRF_SAADC->TASKS_SAMPLE = 1;
+
+  isConversionStarted = true;
+}
+
+bool read_conversion(uint16_t& value) {
+  if (not isConversionStarted or NRF_SAADC->EVENTS_END == 0) return false;
+  isConversionStarted = false;
+
+  // single ended conversions can be slightly negative around 0
+  const int16_t conversion = result;
+  value = constrain(conversion, 0, static_cast<int16_t>(ADC_MAX_VALUE - 1));
+  return true;
+}
+
+}  // namespace saadc
@@ -0,0 +1,37 @@
+#ifndef SAADC_H
+#define SAADC_H
+
+#include <cstdint>
+
+/// Oversampled conversions of one analog pin with the nRF52 SAADC.
+/// The oversampling is done by the SAADC in burst mode and the result is
+/// written by EasyDMA: the CPU only starts a conversion and collects it later.
+/// analogRead must not be used anymore, it reconfigures the SAADC.
+namespace saadc {
+
+// each conversion averages 2^oversamplingExp samples
+constexpr uint8_t oversamplingExp = 6;
+
+/**
+ * \brief Configure the SAADC on an analog pin: 3V range (internal reference),
+ * ADC_RES_EXP bits resolution, and calibrate its offset
+ * \param[in] pin the arduino analog pin
+ * \return false if the pin has no analog input
+ */
+bool setup(const uint32_t pin);
+
+/**
+ * \brief Start an oversampled conversion, without waiting for it
+ */
+void start_conversion();
+
+/**
+ * \brief Collect the result of the last conversion
+ * \param[out] value the converted value, from 0 to ADC_MAX_VALUE - 1
+ * \return false if the conversion is not finished
+ */
+bool read_conversion(uint16_t& value);
+
+}  // namespace saadc
+
+#endif
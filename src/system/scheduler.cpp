@@ -0,0 +1,124 @@
+#include "scheduler.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+
+namespace scheduler {
+
+static constexpr uint8_t taskCount = static_cast<uint8_t>(Task::COUNT);
+
+static uint32_t deadlines[taskCount];
+static bool isTaskEnabled[taskCount];
+// set by the interrupts, consumed by is_due
+static volatile bool isWakeRequested[taskCount];
+
+// thread running each task, notified by the interrupts (nullptr until a
+// thread claims it)
+static TaskHandle_t threads[taskCount];
+
+static std::atomic<uint32_t> wakeupCount(0);
+
+static inline uint8_t index_of(const Task task) {
+  return static_cast<uint8_t>(task);
+}
+
+// signed distance, correct across the millis overflow
+static inline int32_t time_until(const uint32_t deadline,
+                                 const uint32_t time) {
+  return static_cast<int32_t>(deadline - time);
+}
+
+void setup() {
+  const uint32_t time = millis();
+  for (uint8_t i = 0; i < taskCount; ++i) {
+    threads[i] = nullptr;
+    deadlines[i] = time;
+    isTaskEnabled[i] = true;
+    isWakeRequested[i] = false;
+  }
+}
+
+void set_thread(const Task task) {
+  threads[index_of(task)] = xTaskGetCurrentTaskHandle();
+}
+
+void set_enabled(const Task task, const bool isEnabled) {
+  const uint8_t i = index_of(task);
+  if (isTaskEnabled[i] == isEnabled) return;
+
+  isTaskEnabled[i] = isEnabled;
+  // the old deadline may be far in the past
+  if (isEnabled) deadlines[i] = millis();
+}
+
+bool is_due(const Task task, const uint32_t time) {
+  const uint8_t i = index_of(task);
+  if (!isTaskEnabled[i]) return false;
+
+  // clear before running the task: a later interrupt will request it again
+  if (isWakeRequested[i]) {
+    isWakeRequested[i] = false;
+    return true;
+  }
+  return time_until(deadlines[i], time) <= 0;
+}
+
+void set_deadline(const Task task, const uint32_t time) {
+  deadlines[index_of(task)] = time;
+}
+
+void schedule_in(const Task task, const uint32_t delay_ms) {
+  set_deadline(task, millis() + delay_ms);
+}
+
+uint32_t time_to_next_deadline(const uint32_t time) {
+  const TaskHandle_t thread = xTaskGetCurrentTaskHandle();
+  int32_t sleep_ms = maxSleep_ms;
+  for (uint8_t i = 0; i < taskCount; ++i) {
+    // the tasks of the other threads, or of no thread yet (nullptr), are not
+    // waited
+    if (!isTaskEnabled[i] or threads[i] != thread) continue;
+    if (isWakeRequested[i]) return 0;
+
+    const int32_t remaining = time_until(deadlines[i], time);
+    if (remaining <= 0) return 0;
+    if (remaining < sleep_ms) sleep_ms = remaining;
+  }
+  return sleep_ms;
+}
+
+void sleep_until_next_deadline() {
+  const uint32_t sleep_ms = time_to_next_deadline(millis());
+  if (sleep_ms == 0) return;
+
+  // round up, to not wake before the deadline
+  const TickType_t ticks = (sleep_ms * configTICK_RATE_HZ + 999) / 1000;
+
+  // an interrupt raised since the deadline check already incremented the
+  // notification count, so this returns immediately
+  ulTaskNotifyTake(pdTRUE, ticks);
+  wakeupCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void wake_from_isr(const Task task) {
+  const uint8_t i = index_of(task);
+  isWakeRequested[i] = true;
+  if (threads[i] == nullptr) return;
+
+  BaseType_t shouldYield = pdFALSE;
+  vTaskNotifyGiveFromISR(threads[i], &shouldYield);
+  portYIELD_FROM_ISR(shouldYield);
+}
+
+void wake(const Task task) {
+  const uint8_t i = index_of(task);
+  isWakeRequested[i] = true;
+  if (threads[i] != nullptr) xTaskNotifyGive(threads[i]);
+}
+
+uint32_t get_wakeup_count() {
+  return wakeupCount.load(std::memory_order_relaxed);
+}
+
+}  // namespace scheduler
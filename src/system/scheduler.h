@@ -0,0 +1,94 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <cstdint>
+
+/// Deadline scheduler of the firmware threads: each subsystem registers the
+/// time of its next update, and the thread running it sleeps until its
+/// earliest deadline, or until an interrupt (button, PD controller,
+/// microphone) wakes it up.
+namespace scheduler {
+
+enum class Task : uint8_t {
+  BUTTON = 0,   // button reading and serial commands
+  DISPLAY,      // button actions and button color frames
+  ALERTS,       // alert display, charger and PD negociation
+  BATTERY,      // battery alerts and led current limiter
+  TEMPERATURE,  // thermal derating and temperature alerts
+  MICROPHONE,   // microphone power management
+  IMU,          // IMU die temperature and power management
+  USER,         // user loop (animations)
+
+  COUNT
+};
+
+// longest sleep, to keep the watchdog fed even without deadlines
+constexpr uint32_t maxSleep_ms = 1000;
+
+/**
+ * \brief Call in setup, before the interrupts. All tasks are enabled, due
+ * immediately and run by no thread: each thread claims its tasks with
+ * set_thread, until then they never wake or keep awake a thread
+ */
+void setup();
+
+/**
+ * \brief Run a task in the calling thread: its wake up events notify this
+ * thread, and its deadline is waited by this thread
+ */
+void set_thread(const Task task);
+
+/**
+ * \brief Enable or disable a task. A disabled task is never due, and does not
+ * wake the loop. A newly enabled task is due immediately
+ */
+void set_enabled(const Task task, const bool isEnabled);
+
+/**
+ * \brief Check if a task should run, and consume its pending wake up event
+ * \param[in] time current time (millis)
+ * \return true if the task is enabled, and its deadline passed or an
+ * interrupt requested it
+ */
+bool is_due(const Task task, const uint32_t time);
+
+/**
+ * \brief Set the deadline of a task
+ * \param[in] time absolute time of the next update (millis)
+ */
+void set_deadline(const Task task, const uint32_t time);
+
+/**
+ * \brief Set the deadline of a task, relative to now
+ * \param[in] delay_ms time to the next update (milliseconds)
+ */
+void schedule_in(const Task task, const uint32_t delay_ms);
+
+/**
+ * \brief Earliest deadline of the enabled tasks of the calling thread
+ * \param[in] time current time (millis)
+ * \return time until the next deadline (milliseconds), 0 if a task is due,
+ * capped to maxSleep_ms
+ */
+uint32_t time_to_next_deadline(const uint32_t time);
+
+/**
+ * \brief Sleep until the earliest deadline, or until wake_from_isr is called
+ * The idle task enters the low power mode in the meantime
+ */
+void sleep_until_next_deadline();
+
+/**
+ * \brief Make a task due and wake up its thread. Only call from an interrupt
+ */
+void wake_from_isr(const Task task);
+
+// Make a task due and wake up its thread, from another thread
+void wake(const Task task);
+
+// number of times a thread woke up from sleep_until_next_deadline
+uint32_t get_wakeup_count();
+
+}  // namespace scheduler
+
+#endif
@@ -0,0 +1,90 @@
+#include "thermal.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <cmath>
+
+#include "physical/IMU.h"
+#include "utils/constants.h"
+
+namespace thermal {
+
+static constexpr uint32_t samplePeriod_ms = 1000;
+static constexpr float samplePeriod_s = samplePeriod_ms / 1000.0;
+
+// regulate a few degrees under the alert threshold
+static constexpr float targetTemp_c = maxSystemTemp_c - 5.0;
+
+// low pass filter on the temperature (time constant of 10 seconds)
+static constexpr float filterTimeConstant_s = 10.0;
+static constexpr float filterValue =
+    samplePeriod_s / (filterTimeConstant_s + samplePeriod_s);
+
+// PI gains, output ratio by degree over the target.
+// Tuned on a first order model of the lamp (tools/thermal_sim.cpp): 60C
+// rise at full output, 120s to 900s body time constant. The integral time
+// (kp / ki = 25s) stays well under the body time constant, so the loop does
+// not oscillate, and the peak stays under the alert threshold. A stronger ki
+// (0.008) oscillates with kp under 0.1; a stronger kp only trims the peak by
+// a degree.
+static constexpr float kp = 0.05;
+static constexpr float ki = 0.002;  // by degree.second
+static constexpr float minOutputRatio = 0.2;
+
+static float filteredTemp_c = NAN;
+static float cpuTemp_c = NAN;
+static float imuTemp_c = NAN;
+static float integral = 0.0;
+// brightness scaling, written by the sensors thread and read by the alerts
+static std::atomic<float> outputRatio{1.0};
+
+void update() {
+  static uint32_t lastSampleTime = 0;
+  const uint32_t time = millis();
+  if (lastSampleTime != 0 and time - lastSampleTime < samplePeriod_ms) return;
+  lastSampleTime = time;
+
+  cpuTemp_c = readCPUTemperature();
+  imuTemp_c = imu::get_temperature();
+
+  // use the hottest sensor
+  float temperature = cpuTemp_c;
+  if (not std::isnan(imuTemp_c) and imuTemp_c > temperature) {
+    temperature = imuTemp_c;
+  }
+
+  if (std::isnan(filteredTemp_c)) {
+    filteredTemp_c = temperature;
+  } else {
+    filteredTemp_c += filterValue * (temperature - filteredTemp_c);
+  }
+
+  // negative error: too hot
+  const float error = targetTemp_c - filteredTemp_c;
+  const float newIntegral = integral + ki * error * samplePeriod_s;
+  const float output = 1.0 + kp * error + newIntegral;
+
+  // anti windup: stop integrating when the output saturates
+  if (output > 1.0) {
+    integral = min(0.0f, newIntegral);
+    outputRatio.store(1.0);
+  } else if (output < minOutputRatio) {
+    outputRatio.store(minOutputRatio);
+  } else {
+    integral = newIntegral;
+    outputRatio.store(output);
+  }
+}
+
+uint8_t get_brightness_limit(const uint8_t maxBrightness) {
+  return maxBrightness * outputRatio.load();
+}
+
+float get_temperature() { return filteredTemp_c; }
+float get_cpu_temperature() { return cpuTemp_c; }
+float get_imu_temperature() { return imuTemp_c; }
+float get_output_ratio() { return outputRatio.load(); }
+float get_target_temperature() { return targetTemp_c; }
+
+}  // namespace thermal
@@ -0,0 +1,38 @@
+#ifndef THERMAL_H
+#define THERMAL_H
+
+#include <cstdint>
+
+/// Thermal derating: a PI controller on the filtered system temperature sets
+/// the maximum allowed brightness, so the lamp stays at the highest output it
+/// can sustain without overheating.
+namespace thermal {
+
+/**
+ * \brief Sample the temperatures and update the controller. Call at every
+ * loop, the samples are taken once per second
+ */
+void update();
+
+/**
+ * \brief Maximum brightness allowed by the controller
+ * \param[in] maxBrightness the brightness limit when the system is cool
+ */
+uint8_t get_brightness_limit(const uint8_t maxBrightness);
+
+// filtered temperature used by the controller (degrees)
+float get_temperature();
+
+// last raw readings (degrees), the IMU reading is NAN when the IMU is off
+float get_cpu_temperature();
+float get_imu_temperature();
+
+// ratio of the max brightness allowed, from minOutputRatio to 1
+float get_output_ratio();
+
+// target temperature of the controller (degrees)
+float get_target_temperature();
+
+}  // namespace thermal
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef COLOR_PRECISION_H
+#define COLOR_PRECISION_H
+
+#include "fixed_point.h"
+
+// precision of the colorspace conversions:
+// The nRF52840 FPU only handles single precision, double is software emulated
+#define COLORSPACE_DOUBLE 0  // reference precision, very slow
+#define COLORSPACE_FLOAT 1   // hardware float
+#define COLORSPACE_FIXED 2   // Q16.16 fixed point, integer operations only
+
+#ifndef COLORSPACE_PRECISION
+#define COLORSPACE_PRECISION COLORSPACE_FLOAT
+#endif
+
+namespace utils::ColorSpace {
+
+// scalar type used by all colorspace conversions
+#if COLORSPACE_PRECISION == COLORSPACE_DOUBLE
+using real_t = double;
+#elif COLORSPACE_PRECISION == COLORSPACE_FLOAT
+using real_t = float;
+#elif COLORSPACE_PRECISION == COLORSPACE_FIXED
+using real_t = utils::FixedPoint::Fixed16;
+#else
+#error "COLORSPACE_PRECISION must be one of COLORSPACE_DOUBLE, COLORSPACE_FLOAT or COLORSPACE_FIXED"
+#endif
+
+}  // namespace utils::ColorSpace
+
+#endif
@@ -1,256 +1,416 @@
 #include "colorspace.h"
 
+#include <cmath>
+
+#include "colorspace_graph.h"
+#include "linearization.h"
 #include "utils.h"
 
 namespace utils::ColorSpace {
 
-COLOR XYZ::get_rgb() const {
-  double x = this->x / 100.0;
-  double y = this->y / 100.0;
-  double z = this->z / 100.0;
-
-  double r = x * 3.2404542 + y * -1.5371385 + z * -0.4985314;
-  double g = x * -0.9692660 + y * 1.8760108 + z * 0.0415560;
-  double b = x * 0.0556434 + y * -0.2040259 + z * 1.0572252;
+// overloads for float and double, the fixed point ones are found by ADL
+using std::atan2;
+using std::cbrt;
+using std::cos;
+using std::floor;
+using std::fmax;
+using std::fmin;
+using std::fmod;
+using std::sin;
+using std::sqrt;
+
+// all constants are converted at compile time, to prevent any silent promotion
+// to double
+static constexpr real_t zero = real_t(0.0);
+static constexpr real_t one = real_t(1.0);
+static constexpr real_t channelMax = real_t(255.0);
+static constexpr real_t invChannelMax = real_t(1.0 / 255.0);
+static constexpr real_t degToRad = real_t(M_PI / 180.0);
+static constexpr real_t radToDeg = real_t(180.0 / M_PI);
+static constexpr real_t fullTurn = real_t(360.0);
+
+// CIE LAB
+static constexpr real_t labEpsilon = real_t(0.008856);
+static constexpr real_t labKappa = real_t(7.787);
+static constexpr real_t invLabKappa = real_t(1.0 / 7.787);
+static constexpr real_t labOffset = real_t(16.0 / 116.0);
+
+// matrix product of a 3x3 matrix and a vector, in place
+static inline void mat3_mul(const real_t (&m)[3][3], real_t& a, real_t& b,
+                            real_t& c) {
+  const real_t outA = m[0][0] * a + m[0][1] * b + m[0][2] * c;
+  const real_t outB = m[1][0] * a + m[1][1] * b + m[1][2] * c;
+  const real_t outC = m[2][0] * a + m[2][1] * b + m[2][2] * c;
+  a = outA;
+  b = outB;
+  c = outC;
+}
 
-  r = ((r > 0.0031308) ? (1.055 * std::pow(r, 1 / 2.4) - 0.055) : (12.92 * r)) *
-      255.0;
-  g = ((g > 0.0031308) ? (1.055 * std::pow(g, 1 / 2.4) - 0.055) : (12.92 * g)) *
-      255.0;
-  b = ((b > 0.0031308) ? (1.055 * std::pow(b, 1 / 2.4) - 0.055) : (12.92 * b)) *
-      255.0;
+// convert a [0, 1] component to a 8 bit channel, clamped
+static inline uint8_t to_channel(const real_t c) {
+  if (c <= zero) return 0;
+  if (c >= one) return 255;
+  return static_cast<uint8_t>(static_cast<int>(c * channelMax));
+}
 
-  COLOR c;
-  c.red = r;
-  c.green = g;
-  c.blue = b;
-  return c;
+static inline real_t from_channel(const uint8_t c) {
+  return real_t(static_cast<int>(c)) * invChannelMax;
 }
 
-void XYZ::from_rgb(const COLOR& rgb) {
-  double r = rgb.red / 255.0;
-  double g = rgb.green / 255.0;
-  double b = rgb.blue / 255.0;
+// angle in degrees, in [0, 360[
+static inline real_t wrap_degrees(real_t h) {
+  if (h < zero) {
+    h += fullTurn;
+  } else if (h >= fullTurn) {
+    h -= fullTurn;
+  }
+  return h;
+}
 
-  r = ((r > 0.04045) ? std::pow((r + 0.055) / 1.055, 2.4) : (r / 12.92)) *
-      100.0;
-  g = ((g > 0.04045) ? std::pow((g + 0.055) / 1.055, 2.4) : (g / 12.92)) *
-      100.0;
-  b = ((b > 0.04045) ? std::pow((b + 0.055) / 1.055, 2.4) : (b / 12.92)) *
-      100.0;
+static constexpr real_t xyzToLinearRgb[3][3] = {
+    {real_t(3.2404542), real_t(-1.5371385), real_t(-0.4985314)},
+    {real_t(-0.9692660), real_t(1.8760108), real_t(0.0415560)},
+    {real_t(0.0556434), real_t(-0.2040259), real_t(1.0572252)}};
+
+static constexpr real_t linearRgbToXyz[3][3] = {
+    {real_t(0.4124564), real_t(0.3575761), real_t(0.1804375)},
+    {real_t(0.2126729), real_t(0.7151522), real_t(0.0721750)},
+    {real_t(0.0193339), real_t(0.1191920), real_t(0.9503041)}};
+
+static constexpr real_t oklabToLms[3][3] = {
+    {one, real_t(0.3963377774), real_t(0.2158037573)},
+    {one, real_t(-0.1055613458), real_t(-0.0638541728)},
+    {one, real_t(-0.0894841775), real_t(-1.2914855480)}};
+
+static constexpr real_t lmsToLinearRgb[3][3] = {
+    {real_t(4.0767245293), real_t(-3.3072168827), real_t(0.2307590544)},
+    {real_t(-1.2681437731), real_t(2.6093323231), real_t(-0.3411344290)},
+    {real_t(-0.0041119885), real_t(-0.7034763098), real_t(1.7068625689)}};
+
+static constexpr real_t linearRgbToLms[3][3] = {
+    {real_t(0.4122214708), real_t(0.5363325363), real_t(0.0514459929)},
+    {real_t(0.2119034982), real_t(0.6806995451), real_t(0.1073969566)},
+    {real_t(0.0883024619), real_t(0.2817188376), real_t(0.6299787005)}};
+
+static constexpr real_t lmsToOklab[3][3] = {
+    {real_t(0.2104542553), real_t(0.7936177850), real_t(-0.0040720468)},
+    {real_t(1.9779984951), real_t(-2.4285922050), real_t(0.4505937099)},
+    {real_t(0.0259040371), real_t(0.7827717662), real_t(-0.8086757660)}};
+
+// linear RGB to OKLAB, in place
+static inline void linear_to_oklab(real_t& l, real_t& a, real_t& b) {
+  mat3_mul(linearRgbToLms, l, a, b);
+  l = cbrt(l);
+  a = cbrt(a);
+  b = cbrt(b);
+  mat3_mul(lmsToOklab, l, a, b);
+}
 
-  this->x = r * 0.4124564 + g * 0.3575761 + b * 0.1804375;
-  this->y = r * 0.2126729 + g * 0.7151522 + b * 0.0721750;
-  this->z = r * 0.0193339 + g * 0.1191920 + b * 0.9503041;
+// OKLAB to linear RGB, in place
+static inline void oklab_to_linear(real_t& l, real_t& a, real_t& b) {
+  mat3_mul(oklabToLms, l, a, b);
+  l = l * l * l;
+  a = a * a * a;
+  b = b * b * b;
+  mat3_mul(lmsToLinearRgb, l, a, b);
 }
 
-COLOR HSV::get_rgb() const {
-  int range = (int)std::floor(this->h / 60.0);
-  double c = this->v * this->s;
-  double x = c * (1 - abs(std::fmod(this->h / 60.0, 2) - 1.0));
-  double m = this->v - c;
+// OKLAB to 8 bits RGB, for the batch conversions
+static inline COLOR oklab_to_rgb(real_t l, real_t a, real_t b) {
+  oklab_to_linear(l, a, b);
 
   COLOR out;
+  out.white = 0;
+  out.red = from_linear(l);
+  out.green = from_linear(a);
+  out.blue = from_linear(b);
+  return out;
+}
+
+//
+// Edges of the conversion graph
+//
+
+LinearRGB Node<RGB>::to_parent(const RGB& c) {
+  const COLOR& rgb = c.get_rgb();
+  return LinearRGB(to_linear(rgb.red), to_linear(rgb.green),
+                   to_linear(rgb.blue));
+}
+
+RGB Node<RGB>::from_parent(const LinearRGB& c) {
+  return RGB(from_linear(c.r), from_linear(c.g), from_linear(c.b));
+}
+
+LinearRGB Node<SRGB>::to_parent(const SRGB& c) {
+  return LinearRGB(to_linear_exact(c.r), to_linear_exact(c.g),
+                   to_linear_exact(c.b));
+}
+
+SRGB Node<SRGB>::from_parent(const LinearRGB& c) {
+  return SRGB(from_linear_exact(c.r), from_linear_exact(c.g),
+              from_linear_exact(c.b));
+}
+
+SRGB Converter<RGB, SRGB>::apply(const RGB& c) {
+  const COLOR& rgb = c.get_rgb();
+  return SRGB(from_channel(rgb.red), from_channel(rgb.green),
+              from_channel(rgb.blue));
+}
+
+RGB Converter<SRGB, RGB>::apply(const SRGB& c) {
+  return RGB(to_channel(c.r), to_channel(c.g), to_channel(c.b));
+}
+
+LinearRGB Node<XYZ>::to_parent(const XYZ& c) {
+  static constexpr real_t scale = real_t(1.0 / 100.0);
+  real_t r = c.x * scale;
+  real_t g = c.y * scale;
+  real_t b = c.z * scale;
+  mat3_mul(xyzToLinearRgb, r, g, b);
+  return LinearRGB(r, g, b);
+}
+
+XYZ Node<XYZ>::from_parent(const LinearRGB& c) {
+  static constexpr real_t scale = real_t(100.0);
+  real_t x = c.r * scale;
+  real_t y = c.g * scale;
+  real_t z = c.b * scale;
+  mat3_mul(linearRgbToXyz, x, y, z);
+  return XYZ(x, y, z);
+}
+
+LinearRGB Node<OKLAB>::to_parent(const OKLAB& c) {
+  real_t r = c.l;
+  real_t g = c.a;
+  real_t b = c.b;
+  oklab_to_linear(r, g, b);
+  return LinearRGB(r, g, b);
+}
+
+OKLAB Node<OKLAB>::from_parent(const LinearRGB& c) {
+  real_t l = c.r;
+  real_t a = c.g;
+  real_t b = c.b;
+  linear_to_oklab(l, a, b);
+  return OKLAB(l, a, b);
+}
+
+SRGB Node<HSV>::to_parent(const HSV& c) {
+  static constexpr real_t invSector = real_t(1.0 / 60.0);
+  static constexpr real_t two = real_t(2.0);
+
+  int range = static_cast<int>(floor(c.h * invSector));
+  real_t chroma = c.v * c.s;
+  real_t x = fmod(c.h * invSector, two) - one;
+  x = chroma * (one - ((x < zero) ? -x : x));
+  real_t m = c.v - chroma;
+
   switch (range) {
     case 0:
-      out.red = (c + m) * 255;
-      out.green = (x + m) * 255;
-      out.blue = m * 255;
-      break;
+      return SRGB(chroma + m, x + m, m);
     case 1:
-      out.red = (x + m) * 255;
-      out.green = (c + m) * 255;
-      out.blue = m * 255;
-      break;
+      return SRGB(x + m, chroma + m, m);
     case 2:
-      out.red = m * 255;
-      out.green = (c + m) * 255;
-      out.blue = (x + m) * 255;
-      break;
+      return SRGB(m, chroma + m, x + m);
     case 3:
-      out.red = m * 255;
-      out.green = (x + m) * 255;
-      out.blue = (c + m) * 255;
-      break;
+      return SRGB(m, x + m, chroma + m);
     case 4:
-      out.red = (x + m) * 255;
-      out.green = m * 255;
-      out.blue = (c + m) * 255;
-      break;
+      return SRGB(x + m, m, chroma + m);
     default:  // case 5:
-      out.red = (c + m) * 255;
-      out.green = m * 255;
-      out.blue = (x + m) * 255;
-      break;
+      return SRGB(chroma + m, m, x + m);
   }
-  return out;
 }
 
-void HSV::from_rgb(const COLOR& rgb) {
-  double r = rgb.red / 255.0;
-  double g = rgb.green / 255.0;
-  double b = rgb.blue / 255.0;
-
-  double min = std::fmin(r, std::fmin(g, b));
-  double max = std::fmax(r, std::fmax(g, b));
-  double delta = max - min;
-
-  this->v = max;
-  this->s = (max > 1e-3) ? (delta / max) : 0;
-
-  if (delta == 0) {
-    this->h = 0;
-  } else {
-    if (r == max) {
-      this->h = (g - b) / delta;
-    } else if (g == max) {
-      this->h = 2 + (b - r) / delta;
-    } else if (b == max) {
-      this->h = 4 + (r - g) / delta;
+HSV Node<HSV>::from_parent(const SRGB& c) {
+  static constexpr real_t sector = real_t(60.0);
+  static constexpr real_t minValue = real_t(1e-3);
+
+  real_t min = fmin(c.r, fmin(c.g, c.b));
+  real_t max = fmax(c.r, fmax(c.g, c.b));
+  real_t delta = max - min;
+
+  real_t h = zero;
+  if (delta != zero) {
+    if (c.r == max) {
+      h = (c.g - c.b) / delta;
+    } else if (c.g == max) {
+      h = real_t(2.0) + (c.b - c.r) / delta;
+    } else {
+      h = real_t(4.0) + (c.r - c.g) / delta;
     }
-
-    this->h *= 60;
-    this->h = std::fmod(this->h + 360, 360);
+    h = wrap_degrees(h * sector);
   }
+
+  return HSV(h, (max > minValue) ? (delta / max) : zero, max);
 }
 
-// get the rgb form (for display)
-COLOR LAB::get_rgb() const {
+XYZ Node<LAB>::to_parent(const LAB& c) {
   const XYZ& white = XYZ::get_white();
+  real_t y = (c.l + real_t(16.0)) * real_t(1.0 / 116.0);
+  real_t x = c.a * real_t(1.0 / 500.0) + y;
+  real_t z = y - c.b * real_t(1.0 / 200.0);
+
+  real_t x3 = POW3(x);
+  real_t y3 = POW3(y);
+  real_t z3 = POW3(z);
+
+  x = ((x3 > labEpsilon) ? x3 : ((x - labOffset) * invLabKappa)) * white.x;
+  y = ((y3 > labEpsilon) ? y3 : ((y - labOffset) * invLabKappa)) * white.y;
+  z = ((z3 > labEpsilon) ? z3 : ((z - labOffset) * invLabKappa)) * white.z;
+  return XYZ(x, y, z);
+}
 
-  double y = (this->l + 16.0) / 116.0;
-  double x = this->a / 500.0 + y;
-  double z = y - this->b / 200.0;
+LAB Node<LAB>::from_parent(const XYZ& c) {
+  const XYZ& white = XYZ::get_white();
+  real_t x = c.x / white.x;
+  real_t y = c.y / white.y;
+  real_t z = c.z / white.z;
 
-  double x3 = POW3(x);
-  double y3 = POW3(y);
-  double z3 = POW3(z);
+  x = (x > labEpsilon) ? cbrt(x) : (labKappa * x + labOffset);
+  y = (y > labEpsilon) ? cbrt(y) : (labKappa * y + labOffset);
+  z = (z > labEpsilon) ? cbrt(z) : (labKappa * z + labOffset);
 
-  x = ((x3 > 0.008856) ? x3 : ((x - 16.0 / 116.0) / 7.787)) * white.x;
-  y = ((y3 > 0.008856) ? y3 : ((y - 16.0 / 116.0) / 7.787)) * white.y;
-  z = ((z3 > 0.008856) ? z3 : ((z - 16.0 / 116.0) / 7.787)) * white.z;
+  return LAB((real_t(116.0) * y) - real_t(16.0), real_t(500.0) * (x - y),
+             real_t(200.0) * (y - z));
+}
 
-  XYZ xyz(x, y, z);
-  return xyz.get_rgb();
+LAB Node<LCH>::to_parent(const LCH& c) {
+  const real_t newH = c.h * degToRad;
+  return LAB(c.l, cos(newH) * c.c, sin(newH) * c.c);
 }
 
-void LAB::from_rgb(const COLOR& rgb) {
-  const XYZ& white = XYZ::get_white();
+LCH Node<LCH>::from_parent(const LAB& c) {
+  return LCH(c.l, sqrt(c.a * c.a + c.b * c.b),
+             wrap_degrees(atan2(c.b, c.a) * radToDeg));
+}
 
-  XYZ xyz(rgb);
+OKLAB Node<OKLCH>::to_parent(const OKLCH& c) {
+  const real_t newH = c.h * degToRad;
+  return OKLAB(c.l, cos(newH) * c.c, sin(newH) * c.c);
+}
 
-  double x = xyz.x / white.x;
-  double y = xyz.y / white.y;
-  double z = xyz.z / white.z;
+OKLCH Node<OKLCH>::from_parent(const OKLAB& c) {
+  return OKLCH(c.l, sqrt(c.a * c.a + c.b * c.b),
+               wrap_degrees(atan2(c.b, c.a) * radToDeg));
+}
 
-  x = (x > 0.008856) ? std::cbrt(x) : (7.787 * x + 16.0 / 116.0);
-  y = (y > 0.008856) ? std::cbrt(y) : (7.787 * y + 16.0 / 116.0);
-  z = (z > 0.008856) ? std::cbrt(z) : (7.787 * z + 16.0 / 116.0);
+//
+// Color space classes, through the conversion graph
+//
 
-  this->l = (116.0 * y) - 16;
-  this->a = 500 * (x - y);
-  this->b = 200 * (y - z);
-}
+COLOR SRGB::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-COLOR LCH::get_rgb() const {
-  const double newH = this->h * M_PI / 180;
+void SRGB::from_rgb(const COLOR& rgb) { *this = convert<SRGB>(RGB(rgb.color)); }
 
-  LAB lab(this->l, std::cos(newH) * this->c, std::sin(newH) * this->c);
-  return lab.get_rgb();
+COLOR LinearRGB::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
+
+void LinearRGB::from_rgb(const COLOR& rgb) {
+  *this = convert<LinearRGB>(RGB(rgb.color));
 }
 
-void LCH::from_rgb(const COLOR& rgb) {
-  LAB lab(rgb);
+COLOR XYZ::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-  double l = lab.l;
-  double c = std::sqrt(lab.a * lab.a + lab.b * lab.b);
-  double h = std::atan2(lab.b, lab.a);
+void XYZ::from_rgb(const COLOR& rgb) { *this = convert<XYZ>(RGB(rgb.color)); }
 
-  h = h / M_PI * 180;
-  if (h < 0) {
-    h += 360;
-  } else if (h >= 360) {
-    h -= 360;
-  }
+COLOR HSV::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-  this->l = l;
-  this->c = c;
-  this->h = h;
-}
+void HSV::from_rgb(const COLOR& rgb) { *this = convert<HSV>(RGB(rgb.color)); }
 
-// get the rgb form (for display)
-COLOR OKLAB::get_rgb() const {
-  double l = this->l + 0.3963377774 * this->a + 0.2158037573 * this->b;
-  double m = this->l - 0.1055613458 * this->a - 0.0638541728 * this->b;
-  double s = this->l - 0.0894841775 * this->a - 1.2914855480 * this->b;
+COLOR LAB::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-  l = l * l * l;
-  m = m * m * m;
-  s = s * s * s;
+void LAB::from_rgb(const COLOR& rgb) { *this = convert<LAB>(RGB(rgb.color)); }
 
-  double r = 4.0767245293 * l - 3.3072168827 * m + 0.2307590544 * s;
-  double g = -1.2681437731 * l + 2.6093323231 * m - 0.3411344290 * s;
-  double b = -0.0041119885 * l - 0.7034763098 * m + 1.7068625689 * s;
+COLOR LCH::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-  COLOR out;
-  out.red =
-      ((r > 0.0031308) ? (1.055 * std::pow(r, 1 / 2.4) - 0.055) : (12.92 * r)) *
-      255.0;
-  out.green =
-      ((g > 0.0031308) ? (1.055 * std::pow(g, 1 / 2.4) - 0.055) : (12.92 * g)) *
-      255.0;
-  out.blue =
-      ((b > 0.0031308) ? (1.055 * std::pow(b, 1 / 2.4) - 0.055) : (12.92 * b)) *
-      255.0;
-  return out;
-}
+void LCH::from_rgb(const COLOR& rgb) { *this = convert<LCH>(RGB(rgb.color)); }
 
-void OKLAB::from_rgb(const COLOR& rgb) {
-  double r = rgb.red / 255.0;
-  double g = rgb.green / 255.0;
-  double b = rgb.blue / 255.0;
+COLOR OKLAB::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-  r = ((r > 0.04045) ? std::pow((r + 0.055) / 1.055, 2.4) : (r / 12.92));
-  g = ((g > 0.04045) ? std::pow((g + 0.055) / 1.055, 2.4) : (g / 12.92));
-  b = ((b > 0.04045) ? std::pow((b + 0.055) / 1.055, 2.4) : (b / 12.92));
+void OKLAB::from_rgb(const COLOR& rgb) {
+  *this = convert<OKLAB>(RGB(rgb.color));
+}
 
-  double l = 0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b;
-  double m = 0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b;
-  double s = 0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b;
+COLOR OKLCH::get_rgb() const { return convert<RGB>(*this).get_rgb(); }
 
-  l = std::cbrt(l);
-  m = std::cbrt(m);
-  s = std::cbrt(s);
+void OKLCH::from_rgb(const COLOR& rgb) {
+  *this = convert<OKLCH>(RGB(rgb.color));
+}
 
-  this->l = 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s;
-  this->a = 1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s;
-  this->b = 0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s;
+// matrix product of a 3x3 matrix and planar vectors, in place
+static void mat3_mul(const real_t (&m)[3][3], real_t* __restrict a,
+                     real_t* __restrict b, real_t* __restrict c,
+                     const size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    const real_t outA = m[0][0] * a[i] + m[0][1] * b[i] + m[0][2] * c[i];
+    const real_t outB = m[1][0] * a[i] + m[1][1] * b[i] + m[1][2] * c[i];
+    const real_t outC = m[2][0] * a[i] + m[2][1] * b[i] + m[2][2] * c[i];
+    a[i] = outA;
+    b[i] = outB;
+    c[i] = outC;
+  }
 }
 
-COLOR OKLCH::get_rgb() const {
-  const double newH = this->h * M_PI / 180;
+void rgb_to_oklab(const COLOR* __restrict colors, const size_t count,
+                  real_t* __restrict l, real_t* __restrict a,
+                  real_t* __restrict b) {
+  // the output planes are used as scratch for the intermediate spaces
+  for (size_t i = 0; i < count; i++) {
+    l[i] = to_linear(colors[i].red);
+    a[i] = to_linear(colors[i].green);
+    b[i] = to_linear(colors[i].blue);
+  }
+  mat3_mul(linearRgbToLms, l, a, b, count);
 
-  OKLAB lab(this->l, std::cos(newH) * this->c, std::sin(newH) * this->c);
-  return lab.get_rgb();
+  for (size_t i = 0; i < count; i++) {
+    l[i] = cbrt(l[i]);
+    a[i] = cbrt(a[i]);
+    b[i] = cbrt(b[i]);
+  }
+  mat3_mul(lmsToOklab, l, a, b, count);
 }
 
-void OKLCH::from_rgb(const COLOR& rgb) {
-  OKLAB lab(rgb);
+void oklab_to_rgb(const real_t* __restrict l, const real_t* __restrict a,
+                  const real_t* __restrict b, const size_t count,
+                  COLOR* __restrict colors) {
+  for (size_t i = 0; i < count; i++) {
+    colors[i] = oklab_to_rgb(l[i], a[i], b[i]);
+  }
+}
 
-  double l = lab.l;
-  double c = std::sqrt(lab.a * lab.a + lab.b * lab.b);
-  double h = std::atan2(lab.b, lab.a);
+COLOR oklab_blend(const COLOR& start, const COLOR& end, const real_t level) {
+  // the ends are returned as is, to skip the conversion error
+  if (level <= zero) return start;
+  if (level >= one) return end;
+
+  const COLOR colors[2] = {start, end};
+  real_t l[2], a[2], b[2];
+  rgb_to_oklab(colors, 2, l, a, b);
+  return oklab_to_rgb(l[0] + (l[1] - l[0]) * level,
+                      a[0] + (a[1] - a[0]) * level,
+                      b[0] + (b[1] - b[0]) * level);
+}
 
-  h = h / M_PI * 180;
-  if (h < 0) {
-    h += 360;
-  } else if (h >= 360) {
-    h -= 360;
+void rgb_to_oklch(const COLOR* __restrict colors, const size_t count,
+                  real_t* __restrict l, real_t* __restrict c,
+                  real_t* __restrict h) {
+  // c and h hold a and b until the polar conversion
+  rgb_to_oklab(colors, count, l, c, h);
+
+  for (size_t i = 0; i < count; i++) {
+    const real_t a = c[i];
+    const real_t b = h[i];
+    c[i] = sqrt(a * a + b * b);
+    h[i] = wrap_degrees(atan2(b, a) * radToDeg);
   }
+}
 
-  this->l = l;
-  this->c = c;
-  this->h = h;
+void oklch_to_rgb(const real_t* __restrict l, const real_t* __restrict c,
+                  const real_t* __restrict h, const size_t count,
+                  COLOR* __restrict colors) {
+  for (size_t i = 0; i < count; i++) {
+    const real_t newH = h[i] * degToRad;
+    colors[i] = oklab_to_rgb(l[i], cos(newH) * c[i], sin(newH) * c[i]);
+  }
 }
 
-}  // namespace utils::ColorSpace
\ No newline at end of file
+}  // namespace utils::ColorSpace
@@ -1,6 +1,9 @@
 #ifndef COLOR_SPACE_H
 #define COLOR_SPACE_H
 
+#include <cstddef>
+
+#include "color_precision.h"
 #include "utils.h"
 
 namespace utils::ColorSpace {
@@ -10,13 +13,13 @@ class Base {
   virtual COLOR get_rgb() const = 0;
 };
 
-class XYZ : public Base {
+class XYZ final : public Base {
  public:
   XYZ(const COLOR& c) { from_rgb(c); };
-  XYZ(double x, double y, double z) : x(x), y(y), z(z){};
+  XYZ(real_t x, real_t y, real_t z) : x(x), y(y), z(z){};
 
   static XYZ get_white() {
-    static const XYZ white(95.047, 100.000, 108.883);
+    static const XYZ white(real_t(95.047), real_t(100.000), real_t(108.883));
     return white;
   }
 
@@ -24,14 +27,15 @@ class XYZ : public Base {
 
   void from_rgb(const COLOR& rgb);
 
-  double x;
-  double y;
-  double z;
+  real_t x;
+  real_t y;
+  real_t z;
 };
 
-class RGB : public Base {
+class RGB final : public Base {
  public:
   RGB(uint8_t red, uint8_t green, uint8_t blue) {
+    _color.white = 0;
     _color.red = red;
     _color.green = green;
     _color.blue = blue;
@@ -59,86 +63,165 @@ static const RGB TOMATO(255, 99, 71);
 static const RGB ORANGE(255, 140, 0);
 static const RGB PURPLE(128, 0, 128);
 
-class HSV : public Base {
+// sRGB, with unquantized components between 0 and 1
+class SRGB final : public Base {
+ public:
+  SRGB(const COLOR& c) { from_rgb(c); };
+  SRGB(real_t r, real_t g, real_t b) : r(r), g(g), b(b){};
+
+  COLOR get_rgb() const override;
+
+  void from_rgb(const COLOR& rgb);
+
+  real_t r;
+  real_t g;
+  real_t b;
+};
+
+// linear light RGB, with components between 0 and 1
+class LinearRGB final : public Base {
+ public:
+  LinearRGB(const COLOR& c) { from_rgb(c); };
+  LinearRGB(real_t r, real_t g, real_t b) : r(r), g(g), b(b){};
+
+  COLOR get_rgb() const override;
+
+  void from_rgb(const COLOR& rgb);
+
+  real_t r;
+  real_t g;
+  real_t b;
+};
+
+class HSV final : public Base {
  public:
   HSV(const COLOR& c) { from_rgb(c); };
-  HSV(double h, double s, double v) : h(h), s(s), v(v){};
+  HSV(real_t h, real_t s, real_t v) : h(h), s(s), v(v){};
 
   COLOR get_rgb() const override;
 
   void from_rgb(const COLOR& rgb);
 
-  uint16_t get_scaled_hue() const { return h / 360.0 * UINT16_MAX; }
+  uint16_t get_scaled_hue() const {
+    return static_cast<float>(h) / 360.0f * UINT16_MAX;
+  }
 
-  double h;
-  double s;
-  double v;
+  real_t h;
+  real_t s;
+  real_t v;
 };
 
-class LAB : public Base {
+class LAB final : public Base {
  public:
   LAB(const COLOR& c) { from_rgb(c); };
-  LAB(const double l, const double a, const double b) : l(l), a(a), b(b){};
+  LAB(const real_t l, const real_t a, const real_t b) : l(l), a(a), b(b){};
 
   // get the rgb form (for display)
   COLOR get_rgb() const override;
 
   void from_rgb(const COLOR& rgb);
 
-  double l;
-  double a;
-  double b;
+  real_t l;
+  real_t a;
+  real_t b;
 };
 
-class LCH : public Base {
+class LCH final : public Base {
  public:
   LCH(const COLOR& c) { from_rgb(c); };
-  LCH(const double l, const double c, const double h) : l(l), c(c), h(h){};
+  LCH(const real_t l, const real_t c, const real_t h) : l(l), c(c), h(h){};
 
   // get the rgb form (for display)
   COLOR get_rgb() const override;
 
   void from_rgb(const COLOR& rgb);
 
-  uint16_t get_scaled_hue() const { return h / 360.0 * UINT16_MAX; }
+  uint16_t get_scaled_hue() const {
+    return static_cast<float>(h) / 360.0f * UINT16_MAX;
+  }
 
-  double l;
-  double c;
-  double h;  // 0 - 360
+  real_t l;
+  real_t c;
+  real_t h;  // 0 - 360
 };
 
-class OKLAB : public Base {
+class OKLAB final : public Base {
  public:
   OKLAB(const COLOR& c) { from_rgb(c); };
-  OKLAB(const double l, const double a, const double b) : l(l), a(a), b(b){};
+  OKLAB(const real_t l, const real_t a, const real_t b) : l(l), a(a), b(b){};
 
   // get the rgb form (for display)
   COLOR get_rgb() const override;
 
   void from_rgb(const COLOR& rgb);
 
-  double l;
-  double a;
-  double b;
+  real_t l;
+  real_t a;
+  real_t b;
 };
 
-class OKLCH : public Base {
+class OKLCH final : public Base {
  public:
   OKLCH(const COLOR& c) { from_rgb(c); };
-  OKLCH(const double l, const double c, const double h) : l(l), c(c), h(h){};
+  OKLCH(const real_t l, const real_t c, const real_t h) : l(l), c(c), h(h){};
 
   // get the rgb form (for display)
   COLOR get_rgb() const override;
 
   void from_rgb(const COLOR& rgb);
 
-  uint16_t get_scaled_hue() const { return h / 360.0 * UINT16_MAX; }
+  uint16_t get_scaled_hue() const {
+    return static_cast<float>(h) / 360.0f * UINT16_MAX;
+  }
 
-  double l;
-  double c;
-  double h;  // 0 - 360
+  real_t l;
+  real_t c;
+  real_t h;  // 0 - 360
 };
 
+/**
+ * \brief Color between two colors, interpolated in OKLAB on each call: exact,
+ * but slower than a utils::Gradient lookup. For colors computed once in a
+ * while
+ * \param[in] start, end The colors to interpolate
+ * \param[in] level between 0 (start) and 1 (end)
+ */
+COLOR oklab_blend(const COLOR& start, const COLOR& end, const real_t level);
+
+/**
+ * Batch conversions, between packed colors and planar arrays (one array per
+ * component). Prefer those to the classes above when converting more than a
+ * few colors: there is no virtual call and no temporary object, and the
+ * loops can be vectorized by the compiler.
+ * The arrays must not overlap.
+ */
+
+/**
+ * \brief Convert a span of colors to OKLAB planes
+ * \param[in] colors The colors to convert
+ * \param[in] count Number of colors, and size of each output plane
+ * \param[out] l, a, b The OKLAB components
+ */
+void rgb_to_oklab(const COLOR* __restrict colors, const size_t count,
+                  real_t* __restrict l, real_t* __restrict a,
+                  real_t* __restrict b);
+void oklab_to_rgb(const real_t* __restrict l, const real_t* __restrict a,
+                  const real_t* __restrict b, const size_t count,
+                  COLOR* __restrict colors);
+
+/**
+ * \brief Convert a span of colors to OKLCH planes
+ * \param[in] colors The colors to convert
+ * \param[in] count Number of colors, and size of each output plane
+ * \param[out] l, c, h The OKLCH components, h in degrees (0 - 360)
+ */
+void rgb_to_oklch(const COLOR* __restrict colors, const size_t count,
+                  real_t* __restrict l, real_t* __restrict c,
+                  real_t* __restrict h);
+void oklch_to_rgb(const real_t* __restrict l, const real_t* __restrict c,
+                  const real_t* __restrict h, const size_t count,
+                  COLOR* __restrict colors);
+
 }  // namespace utils::ColorSpace
 
 #endif
\ No newline at end of file
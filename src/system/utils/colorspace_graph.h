@@ -0,0 +1,163 @@
+#ifndef COLOR_SPACE_GRAPH_H
+#define COLOR_SPACE_GRAPH_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "colorspace.h"
+
+/// Compile time conversion graph between the color spaces.
+/// The spaces form a tree rooted on linear RGB, each one only knows how to
+/// convert to and from its parent. convert<To>(from) walks the tree through
+/// the closest common parent, with no virtual call and no 8 bits
+/// quantization between the two ends:
+///
+/// LinearRGB
+///  |- RGB (8 bits channels)
+///  |- SRGB
+///  |   |- HSV
+///  |- XYZ
+///  |   |- LAB
+///  |       |- LCH
+///  |- OKLAB
+///      |- OKLCH
+///
+/// Some pairs have a direct conversion (shortcut) that skips the tree.
+namespace utils::ColorSpace {
+
+/**
+ * \brief Position of a color space in the conversion tree.
+ * Specializations define the parent space, the depth in the tree, and the
+ * conversions to and from the parent.
+ */
+template <class Space>
+struct Node;
+
+template <>
+struct Node<LinearRGB> {
+  static constexpr uint8_t depth = 0;
+};
+
+template <>
+struct Node<RGB> {
+  using Parent = LinearRGB;
+  static constexpr uint8_t depth = 1;
+  static LinearRGB to_parent(const RGB& c);
+  static RGB from_parent(const LinearRGB& c);
+};
+
+template <>
+struct Node<SRGB> {
+  using Parent = LinearRGB;
+  static constexpr uint8_t depth = 1;
+  static LinearRGB to_parent(const SRGB& c);
+  static SRGB from_parent(const LinearRGB& c);
+};
+
+template <>
+struct Node<XYZ> {
+  using Parent = LinearRGB;
+  static constexpr uint8_t depth = 1;
+  static LinearRGB to_parent(const XYZ& c);
+  static XYZ from_parent(const LinearRGB& c);
+};
+
+template <>
+struct Node<OKLAB> {
+  using Parent = LinearRGB;
+  static constexpr uint8_t depth = 1;
+  static LinearRGB to_parent(const OKLAB& c);
+  static OKLAB from_parent(const LinearRGB& c);
+};
+
+template <>
+struct Node<HSV> {
+  using Parent = SRGB;
+  static constexpr uint8_t depth = 2;
+  static SRGB to_parent(const HSV& c);
+  static HSV from_parent(const SRGB& c);
+};
+
+template <>
+struct Node<LAB> {
+  using Parent = XYZ;
+  static constexpr uint8_t depth = 2;
+  static XYZ to_parent(const LAB& c);
+  static LAB from_parent(const XYZ& c);
+};
+
+template <>
+struct Node<OKLCH> {
+  using Parent = OKLAB;
+  static constexpr uint8_t depth = 2;
+  static OKLAB to_parent(const OKLCH& c);
+  static OKLCH from_parent(const OKLAB& c);
+};
+
+template <>
+struct Node<LCH> {
+  using Parent = LAB;
+  static constexpr uint8_t depth = 3;
+  static LAB to_parent(const LCH& c);
+  static LCH from_parent(const LAB& c);
+};
+
+/**
+ * \brief Conversion between two spaces, resolved at compile time.
+ * The deepest side climbs to its parent until both sides meet.
+ */
+template <class From, class To, class Enable = void>
+struct Converter;
+
+// same space: nothing to do
+template <class Space>
+struct Converter<Space, Space> {
+  static Space apply(const Space& c) { return c; }
+};
+
+// source is deeper (or as deep): climb from the source
+template <class From, class To>
+struct Converter<
+    From, To,
+    typename std::enable_if<not std::is_same<From, To>::value and
+                            (Node<From>::depth >= Node<To>::depth)>::type> {
+  static To apply(const From& c) {
+    return Converter<typename Node<From>::Parent, To>::apply(
+        Node<From>::to_parent(c));
+  }
+};
+
+// target is deeper: reach the target parent, then go down
+template <class From, class To>
+struct Converter<
+    From, To,
+    typename std::enable_if<(Node<From>::depth < Node<To>::depth)>::type> {
+  static To apply(const From& c) {
+    return Node<To>::from_parent(
+        Converter<From, typename Node<To>::Parent>::apply(c));
+  }
+};
+
+// shortcut: 8 bits channels are sRGB values, no need to linearize
+template <>
+struct Converter<RGB, SRGB> {
+  static SRGB apply(const RGB& c);
+};
+
+template <>
+struct Converter<SRGB, RGB> {
+  static RGB apply(const SRGB& c);
+};
+
+/**
+ * \brief Convert a color to another color space
+ * ex: convert<OKLCH>(LCH(50, 20, 180))
+ */
+template <class To, class From>
+To convert(const From& color) {
+  return Converter<From, To>::apply(color);
+}
+
+}  // namespace utils::ColorSpace
+
+#endif
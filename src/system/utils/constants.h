@@ -55,6 +55,10 @@ constexpr float maxConvertedVoltage =
 constexpr float maxPowerConsumption_A =
     2.6;  // Maxpower draw allowed on the system (Amperes)
 
+// power budget of the system, enforced by the led current limiter
+constexpr uint16_t maxDischargeCurrent_mA = 3000;  // battery discharge (mA)
+constexpr float maxSystemPower_W = 40;             // system power (Watts)
+
 constexpr float maxSystemTemp_c = 70;       // max proc temperature, in degrees
 constexpr float criticalSystemTemp_c = 80;  // max proc temperature, in degrees
 
@@ -70,6 +74,7 @@ constexpr float batteryCritical = 3;  // %
 constexpr float batteryLow = 5;       // %
 
 constexpr uint32_t batteryMaxChargeCurrent = 1000;  // mA
+constexpr float batteryCapacity_mAh = 2500;  // nominal capacity of the pack
 
 // pins
 
@@ -0,0 +1,67 @@
+#ifndef CONSTEXPR_UTILS_H
+#define CONSTEXPR_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// Compile time helpers, used to generate the lookup tables stored in flash.
+/// Everything is a single return statement, so it works in C++11 constexpr.
+namespace utils::Constexpr {
+
+// sequence of indexes, to expand a table generator on all entries
+template <size_t... I>
+struct IndexSequence {};
+
+template <size_t N, size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct MakeIndexSequence<0, I...> : IndexSequence<I...> {};
+
+constexpr double ln2 = 0.693147180559945309417;
+
+constexpr double square(const double x) { return x * x; }
+constexpr double cube(const double x) { return x * x * x; }
+
+// taylor series of exp(x), precise for |x| <= 0.5
+constexpr double exp_series(const double x, const double term,
+                            const uint8_t n) {
+  return (n > 20) ? term : term + exp_series(x, term * x / n, n + 1);
+}
+
+// exponential, the argument is halved until the series converges fast
+constexpr double exp(const double x) {
+  return (x > 0.5 or x < -0.5) ? square(exp(x / 2.0))
+                               : exp_series(x, 1.0, 1);
+}
+
+// series of 2 * atanh(z) = ln((1 + z) / (1 - z))
+constexpr double ln_series(const double z, const double z2,
+                           const double term, const uint8_t n) {
+  return (n > 40) ? 0.0
+                  : term / (2 * n + 1) + ln_series(z, z2, term * z2, n + 1);
+}
+
+// natural logarithm, the argument is reduced in [1, 2[
+constexpr double ln(const double x) {
+  return (x < 1.0)   ? ln(x * 2.0) - ln2
+         : (x >= 2.0) ? ln(x / 2.0) + ln2
+                      : 2.0 * ln_series((x - 1.0) / (x + 1.0),
+                                        square((x - 1.0) / (x + 1.0)),
+                                        (x - 1.0) / (x + 1.0), 0);
+}
+
+// x to the power of y, for x >= 0
+constexpr double pow(const double x, const double y) {
+  return (x <= 0.0) ? 0.0 : exp(y * ln(x));
+}
+
+// round to the nearest integer and clamp in [low, high]
+constexpr uint32_t round_clamp(const double x, const uint32_t low,
+                               const uint32_t high) {
+  return (x <= low) ? low : (x >= high) ? high : uint32_t(x + 0.5);
+}
+
+}  // namespace utils::Constexpr
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef CURVES_H
+#define CURVES_H
+
+#include <cstdint>
+
+#include "constexpr_utils.h"
+
+namespace utils {
+
+/**
+ * \brief 256 entries correction curve for 8 bits values
+ */
+struct Curve8 {
+  uint8_t values[256];
+
+  constexpr uint8_t operator[](const uint8_t index) const {
+    return values[index];
+  }
+};
+
+/**
+ * \brief 256 entries correction curve for 16 bits values
+ * Entry i is the output for the 8 bits input i (16 bits value i * 257), values
+ * in between are linearly interpolated.
+ */
+struct Curve16 {
+  uint16_t values[256];
+
+  uint16_t operator()(const uint16_t value) const {
+    const uint8_t index = value / 257;
+    const uint16_t fraction = value % 257;
+    if (fraction == 0) return values[index];
+
+    return values[index] +
+           ((uint32_t(values[index + 1] - values[index]) * fraction) / 257);
+  }
+};
+
+namespace Curves {
+
+constexpr uint8_t gamma_value(const size_t index, const double gamma) {
+  return Constexpr::round_clamp(
+      Constexpr::pow(index / 255.0, gamma) * 255.0, 0, 255);
+}
+
+constexpr uint16_t gamma_value16(const size_t index, const double gamma) {
+  return Constexpr::round_clamp(
+      Constexpr::pow(index / 255.0, gamma) * 65535.0, 0, 65535);
+}
+
+// CIE 1931 lightness: perceived lightness L* (0 - 100) to luminance (0 - 1)
+constexpr double cie1931_luminance(const double lightness) {
+  return (lightness <= 8.0) ? lightness / 903.3
+                            : Constexpr::cube((lightness + 16.0) / 116.0);
+}
+
+constexpr uint8_t cie1931_value(const size_t index) {
+  return Constexpr::round_clamp(
+      cie1931_luminance(index * 100.0 / 255.0) * 255.0, 0, 255);
+}
+
+template <size_t... I>
+constexpr Curve8 make_gamma(Constexpr::IndexSequence<I...>,
+                            const double gamma) {
+  return Curve8{{gamma_value(I, gamma)...}};
+}
+
+template <size_t... I>
+constexpr Curve16 make_gamma16(Constexpr::IndexSequence<I...>,
+                               const double gamma) {
+  return Curve16{{gamma_value16(I, gamma)...}};
+}
+
+template <size_t... I>
+constexpr Curve8 make_cie1931(Constexpr::IndexSequence<I...>) {
+  return Curve8{{cie1931_value(I)...}};
+}
+
+}  // namespace Curves
+
+/**
+ * \brief Gamma correction curve, computed at compile time and stored in flash
+ * Each gamma value used in the program is a distinct table, so switching
+ * between them costs nothing.
+ * \tparam gammaX100 The gamma value, in hundredths (280 for a 2.8 gamma)
+ */
+template <uint16_t gammaX100>
+struct GammaCurve {
+  static constexpr Curve8 table = Curves::make_gamma(
+      Constexpr::MakeIndexSequence<256>(), gammaX100 / 100.0);
+};
+
+template <uint16_t gammaX100>
+constexpr Curve8 GammaCurve<gammaX100>::table;
+
+/**
+ * \brief 16 bits gamma correction curve, computed at compile time
+ * \tparam gammaX100 The gamma value, in hundredths (280 for a 2.8 gamma)
+ */
+template <uint16_t gammaX100>
+struct GammaCurve16 {
+  static constexpr Curve16 table = Curves::make_gamma16(
+      Constexpr::MakeIndexSequence<256>(), gammaX100 / 100.0);
+};
+
+template <uint16_t gammaX100>
+constexpr Curve16 GammaCurve16<gammaX100>::table;
+
+/**
+ * \brief CIE 1931 lightness curve: maps a perceived brightness to the light
+ * output, stored in flash
+ */
+struct Cie1931Curve {
+  static constexpr Curve8 table =
+      Curves::make_cie1931(Constexpr::MakeIndexSequence<256>());
+};
+
+}  // namespace utils
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef DITHER_H
+#define DITHER_H
+
+#include <cstdint>
+
+namespace utils {
+
+/**
+ * \brief Temporal dithering of a 16 bits level on an 8 bits output.
+ * The quantization error of each frame is carried to the next one (error
+ * diffusion), so the average output over successive frames matches the 16
+ * bits target. Call next() once per frame (loop tick).
+ */
+class Dither8 {
+ public:
+  Dither8() : _target(0), _error(0) {}
+
+  /**
+   * \brief Set the level to reproduce
+   * \param[in] target between 0 and UINT16_MAX (maximum output)
+   */
+  void set_target(const uint16_t target) { _target = target; }
+  uint16_t get_target() const { return _target; }
+
+  // closest 8 bits output to the target, without dithering
+  uint8_t get_rounded() const {
+    return (uint32_t(_target) * 255 + UINT16_MAX / 2) / UINT16_MAX;
+  }
+
+  /**
+   * \brief Compute the output value of the next frame
+   * \return the 8 bits output value
+   */
+  uint8_t next() {
+    // output level, in 1/UINT16_MAX of an output step
+    const uint32_t level = uint32_t(_target) * 255 + _error;
+    const uint8_t output = level / UINT16_MAX;
+    _error = level - uint32_t(output) * UINT16_MAX;
+    return output;
+  }
+
+ private:
+  uint16_t _target;
+  uint16_t _error;
+};
+
+}  // namespace utils
+
+#endif
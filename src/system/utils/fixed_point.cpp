@@ -0,0 +1,238 @@
+#include "fixed_point.h"
+
+namespace utils::FixedPoint {
+
+// internal representation of the CORDIC and logarithm computations (Q2.30)
+static constexpr uint8_t internalBits = 30;
+static constexpr uint8_t internalShift = internalBits - Fixed16::fractionalBits;
+
+static constexpr int32_t piRaw = 205887;      // pi, Q16.16
+static constexpr int32_t halfPiRaw = 102944;  // pi / 2, Q16.16
+static constexpr int32_t twoPiRaw = 411775;   // 2 * pi, Q16.16
+
+// 1 / CORDIC gain, Q2.30
+static constexpr int32_t cordicInvGain = 652032874;
+// atan(2^-i), Q2.30
+static constexpr uint8_t cordicIterations = 24;
+static const int32_t cordicAtan[cordicIterations] = {
+    843314857, 497837829, 263043837, 133525159, 67021687, 33543516,
+    16775851,  8388437,   4194283,   2097149,   1048576,  524288,
+    262144,    131072,    65536,     32768,     16384,    8192,
+    4096,      2048,      1024,      512,       256,      128};
+
+// 2^(2^-i) for i in [1, 16], Q2.30
+static const uint32_t exp2Fractions[Fixed16::fractionalBits] = {
+    1518500250, 1276901417, 1170923762, 1121280436, 1097253708, 1085434106,
+    1079572136, 1076653033, 1075196443, 1074468888, 1074105294, 1073923544,
+    1073832680, 1073787251, 1073764537, 1073753181};
+
+Fixed16 fabs(const Fixed16 x) { return x.raw < 0 ? -x : x; }
+
+Fixed16 floor(const Fixed16 x) {
+  return Fixed16::from_raw(x.raw & ~(Fixed16::one - 1));
+}
+
+Fixed16 fmod(const Fixed16 x, const Fixed16 y) {
+  if (y.raw == 0) return Fixed16::saturated(x.raw);
+  return Fixed16::from_raw(x.raw % y.raw);
+}
+
+Fixed16 fmin(const Fixed16 a, const Fixed16 b) { return a < b ? a : b; }
+Fixed16 fmax(const Fixed16 a, const Fixed16 b) { return a > b ? a : b; }
+
+Fixed16 sqrt(const Fixed16 x) {
+  if (x.raw <= 0) return Fixed16();
+
+  // sqrt(raw / 2^16) * 2^16 = sqrt(raw * 2^16)
+  uint64_t value = uint64_t(x.raw) << Fixed16::fractionalBits;
+  uint64_t result = 0;
+  uint64_t bit = uint64_t(1) << 62;
+  while (bit > value) bit >>= 2;
+
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return Fixed16::from_raw(static_cast<int32_t>(result));
+}
+
+Fixed16 cbrt(const Fixed16 x) {
+  if (x.raw == 0) return Fixed16();
+
+  // cbrt(raw / 2^16) * 2^16 = cbrt(raw * 2^32)
+  const bool isNegative = x.raw < 0;
+  uint64_t value = uint64_t(isNegative ? -int64_t(x.raw) : x.raw) << 32;
+  uint64_t result = 0;
+  for (int8_t shift = 63; shift >= 0; shift -= 3) {
+    result <<= 1;
+    const uint64_t b = 3 * result * (result + 1) + 1;
+    if ((value >> shift) >= b) {
+      value -= b << shift;
+      result++;
+    }
+  }
+
+  const int32_t raw = static_cast<int32_t>(result);
+  return Fixed16::from_raw(isNegative ? -raw : raw);
+}
+
+Fixed16 log2(const Fixed16 x) {
+  if (x.raw <= 0) return Fixed16::from_raw(INT32_MIN);
+
+  // integer part: position of the highest set bit
+  uint32_t mantissa = x.raw;
+  int8_t highestBit = 31;
+  while ((mantissa & (1UL << highestBit)) == 0) highestBit--;
+  int32_t result = (highestBit - Fixed16::fractionalBits) * Fixed16::one;
+
+  // normalize the mantissa in [1, 2[ (Q2.30)
+  if (highestBit > internalBits)
+    mantissa >>= highestBit - internalBits;
+  else
+    mantissa <<= internalBits - highestBit;
+
+  // fractional part: one bit per squaring of the mantissa
+  for (int32_t bit = Fixed16::one >> 1; bit != 0; bit >>= 1) {
+    mantissa = static_cast<uint32_t>((uint64_t(mantissa) * mantissa) >>
+                                     internalBits);
+    if (mantissa >= (2UL << internalBits)) {
+      mantissa >>= 1;
+      result += bit;
+    }
+  }
+  return Fixed16::from_raw(result);
+}
+
+Fixed16 exp2(const Fixed16 x) {
+  // split in integer and fractional parts
+  const int32_t integer = x.raw >> Fixed16::fractionalBits;
+  const uint32_t fraction = x.raw & (Fixed16::one - 1);
+
+  // saturate
+  const int32_t shift = internalShift - integer;
+  if (shift < 0) return Fixed16::from_raw(INT32_MAX);
+  if (shift > internalBits) return Fixed16();
+
+  // 2^fraction, as a product of 2^(2^-i) for each set bit
+  uint32_t result = 1UL << internalBits;
+  for (uint8_t i = 0; i < Fixed16::fractionalBits; i++) {
+    if (fraction & (1UL << (Fixed16::fractionalBits - 1 - i))) {
+      result = static_cast<uint32_t>((uint64_t(result) * exp2Fractions[i]) >>
+                                     internalBits);
+    }
+  }
+
+  // apply the integer part
+  return Fixed16::from_raw(result >> shift);
+}
+
+Fixed16 pow(const Fixed16 x, const Fixed16 y) {
+  if (x.raw <= 0) return Fixed16();
+  if (y.raw == 0) return Fixed16(1);
+  return exp2(y * log2(x));
+}
+
+// rotation mode CORDIC: compute sin and cos of the angle
+static void sin_cos(const Fixed16 angle, Fixed16& sinOut, Fixed16& cosOut) {
+  // reduce to [-pi, pi]
+  int32_t reduced = angle.raw % twoPiRaw;
+  if (reduced > piRaw)
+    reduced -= twoPiRaw;
+  else if (reduced < -piRaw)
+    reduced += twoPiRaw;
+
+  // reduce to [-pi/2, pi/2], where the CORDIC iterations converge
+  bool isFlipped = false;
+  if (reduced > halfPiRaw) {
+    reduced -= piRaw;
+    isFlipped = true;
+  } else if (reduced < -halfPiRaw) {
+    reduced += piRaw;
+    isFlipped = true;
+  }
+
+  int32_t x = cordicInvGain;
+  int32_t y = 0;
+  int32_t z = reduced << internalShift;
+  for (uint8_t i = 0; i < cordicIterations; i++) {
+    const int32_t dx = x >> i;
+    const int32_t dy = y >> i;
+    if (z >= 0) {
+      x -= dy;
+      y += dx;
+      z -= cordicAtan[i];
+    } else {
+      x += dy;
+      y -= dx;
+      z += cordicAtan[i];
+    }
+  }
+
+  // round back to Q16.16
+  x = (x + (1 << (internalShift - 1))) >> internalShift;
+  y = (y + (1 << (internalShift - 1))) >> internalShift;
+  cosOut = Fixed16::from_raw(isFlipped ? -x : x);
+  sinOut = Fixed16::from_raw(isFlipped ? -y : y);
+}
+
+Fixed16 sin(const Fixed16 angle) {
+  Fixed16 s, c;
+  sin_cos(angle, s, c);
+  return s;
+}
+
+Fixed16 cos(const Fixed16 angle) {
+  Fixed16 s, c;
+  sin_cos(angle, s, c);
+  return c;
+}
+
+// vectoring mode CORDIC: rotate the vector to the x axis
+Fixed16 atan2(const Fixed16 y, const Fixed16 x) {
+  if (x.raw == 0 and y.raw == 0) return Fixed16();
+
+  int32_t xi = x.raw;
+  int32_t yi = y.raw;
+  int32_t offset = 0;
+  // left half plane: rotate by pi
+  if (xi < 0) {
+    offset = (yi >= 0) ? piRaw : -piRaw;
+    xi = -xi;
+    yi = -yi;
+  }
+
+  // keep headroom for the CORDIC gain, and enough bits for the precision
+  while (xi >= (1L << 29) or yi >= (1L << 29) or yi <= -(1L << 29)) {
+    xi >>= 1;
+    yi >>= 1;
+  }
+  while (xi < (1L << 28) and yi < (1L << 28) and yi > -(1L << 28)) {
+    xi <<= 1;
+    yi <<= 1;
+  }
+
+  int32_t z = 0;
+  for (uint8_t i = 0; i < cordicIterations; i++) {
+    const int32_t dx = xi >> i;
+    const int32_t dy = yi >> i;
+    if (yi > 0) {
+      xi += dy;
+      yi -= dx;
+      z += cordicAtan[i];
+    } else {
+      xi -= dy;
+      yi += dx;
+      z -= cordicAtan[i];
+    }
+  }
+
+  z = (z + (1 << (internalShift - 1))) >> internalShift;
+  return Fixed16::from_raw(z + offset);
+}
+
+}  // namespace utils::FixedPoint
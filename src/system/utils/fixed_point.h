@@ -0,0 +1,123 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+
+namespace utils::FixedPoint {
+
+/**
+ * \brief Signed Q16.16 fixed point number.
+ * Covers -32768 to 32767.99998 in steps of 1/65536, with integer only
+ * operations. Multiplications and divisions go through a 64 bits intermediate
+ * to keep the full precision.
+ */
+class Fixed16 {
+ public:
+  static constexpr uint8_t fractionalBits = 16;
+  static constexpr int32_t one = 1 << fractionalBits;
+
+  constexpr Fixed16() : raw(0) {}
+  constexpr Fixed16(const int value) : raw(value * one) {}
+  constexpr Fixed16(const long value) : raw(value * one) {}
+  constexpr Fixed16(const float value)
+      : raw(static_cast<int32_t>(value * one + (value >= 0 ? 0.5f : -0.5f))) {}
+  constexpr Fixed16(const double value)
+      : raw(static_cast<int32_t>(value * one + (value >= 0 ? 0.5 : -0.5))) {}
+
+  static constexpr Fixed16 from_raw(const int32_t value) {
+    return Fixed16(value, RawTag());
+  }
+
+  explicit constexpr operator int() const { return raw / one; }
+  explicit constexpr operator float() const { return raw / float(one); }
+  explicit constexpr operator double() const { return raw / double(one); }
+
+  friend constexpr Fixed16 operator+(const Fixed16 a, const Fixed16 b) {
+    return from_raw(a.raw + b.raw);
+  }
+  friend constexpr Fixed16 operator-(const Fixed16 a, const Fixed16 b) {
+    return from_raw(a.raw - b.raw);
+  }
+  friend constexpr Fixed16 operator*(const Fixed16 a, const Fixed16 b) {
+    return from_raw(static_cast<int32_t>((int64_t(a.raw) * b.raw) >> 16));
+  }
+  // out of range quotients saturate, a division by zero gives the max (or the
+  // min for a negative dividend)
+  friend constexpr Fixed16 operator/(const Fixed16 a, const Fixed16 b) {
+    return (b.raw == 0) ? saturated(a.raw)
+                        : from_raw(saturate((int64_t(a.raw) * one) / b.raw));
+  }
+  constexpr Fixed16 operator-() const { return from_raw(-raw); }
+
+  Fixed16& operator+=(const Fixed16 other) { return *this = *this + other; }
+  Fixed16& operator-=(const Fixed16 other) { return *this = *this - other; }
+  Fixed16& operator*=(const Fixed16 other) { return *this = *this * other; }
+  Fixed16& operator/=(const Fixed16 other) { return *this = *this / other; }
+
+  friend constexpr bool operator==(const Fixed16 a, const Fixed16 b) {
+    return a.raw == b.raw;
+  }
+  friend constexpr bool operator!=(const Fixed16 a, const Fixed16 b) {
+    return a.raw != b.raw;
+  }
+  friend constexpr bool operator<(const Fixed16 a, const Fixed16 b) {
+    return a.raw < b.raw;
+  }
+  friend constexpr bool operator>(const Fixed16 a, const Fixed16 b) {
+    return a.raw > b.raw;
+  }
+  friend constexpr bool operator<=(const Fixed16 a, const Fixed16 b) {
+    return a.raw <= b.raw;
+  }
+  friend constexpr bool operator>=(const Fixed16 a, const Fixed16 b) {
+    return a.raw >= b.raw;
+  }
+
+  int32_t raw;
+
+ private:
+  struct RawTag {};
+  constexpr Fixed16(const int32_t value, RawTag) : raw(value) {}
+
+  static constexpr int32_t saturate(const int64_t value) {
+    return (value > INT32_MAX)   ? INT32_MAX
+           : (value < INT32_MIN) ? INT32_MIN
+                                 : static_cast<int32_t>(value);
+  }
+  // largest value, with the sign of x
+  static constexpr Fixed16 saturated(const int32_t x) {
+    return from_raw(x < 0 ? INT32_MIN : INT32_MAX);
+  }
+
+  friend Fixed16 fmod(const Fixed16 x, const Fixed16 y);
+};
+
+// math functions, found by argument dependant lookup next to the std ones
+
+Fixed16 fabs(const Fixed16 x);
+Fixed16 floor(const Fixed16 x);
+// saturates like the division when y is zero
+Fixed16 fmod(const Fixed16 x, const Fixed16 y);
+Fixed16 fmin(const Fixed16 a, const Fixed16 b);
+Fixed16 fmax(const Fixed16 a, const Fixed16 b);
+
+Fixed16 sqrt(const Fixed16 x);
+Fixed16 cbrt(const Fixed16 x);
+
+/**
+ * \brief Logarithm and power of two, precise to the last fractional bit
+ * \param[in] x must be strictly positive for log2
+ */
+Fixed16 log2(const Fixed16 x);
+Fixed16 exp2(const Fixed16 x);
+// x to the power of y, for x >= 0
+Fixed16 pow(const Fixed16 x, const Fixed16 y);
+
+// trigonometry, angles in radians. Computed with CORDIC iterations
+Fixed16 sin(const Fixed16 angle);
+Fixed16 cos(const Fixed16 angle);
+Fixed16 atan2(const Fixed16 y, const Fixed16 x);
+
+}  // namespace utils::FixedPoint
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "colorspace.h"
+#include "utils.h"
+
+namespace utils {
+
+/**
+ * \brief Perceptual color gradient between evenly spaced color stops.
+ * The gradient is interpolated in OKLAB once, into a table of steps colors.
+ * A lookup is then a table read and an integer blend of two entries.
+ * The table is only rebuilt when the stops change.
+ * \tparam steps Number of precomputed colors (at least 2)
+ * \tparam maxStops Maximum number of color stops
+ */
+template <uint16_t steps, uint8_t maxStops = 4>
+class Gradient {
+  static_assert(steps >= 2, "A gradient needs at least 2 steps");
+  static_assert(maxStops >= 2, "A gradient needs at least 2 stops");
+
+ public:
+  Gradient() : _stopCount(0) {}
+  Gradient(std::initializer_list<uint32_t> stops) : _stopCount(0) {
+    set_stops(stops);
+  }
+
+  /**
+   * \brief Set the color stops, rebuild the table if they changed
+   * \param[in] stops between 2 and maxStops colors, from start to end
+   */
+  void set_stops(std::initializer_list<uint32_t> stops) {
+    if (stops.size() < 2 or stops.size() > maxStops) return;
+
+    bool isSame = (stops.size() == _stopCount);
+    uint8_t i = 0;
+    for (const uint32_t stop : stops) {
+      isSame = isSame and (_stops[i].color == stop);
+      _stops[i++].color = stop;
+    }
+    if (isSame) return;
+
+    _stopCount = stops.size();
+    build();
+  }
+
+  /**
+   * \brief Get the color at a given position of the gradient
+   * \param[in] level between 0 (start) and UINT16_MAX (end)
+   */
+  uint32_t get_color16(const uint16_t level) const {
+    if (_stopCount == 0) return 0;
+
+    // 8 bits of fraction between two consecutive steps
+    const uint32_t position = (uint32_t(level) * (steps - 1)) >> 8;
+    const uint16_t index = position >> 8;
+    if (index >= steps - 1) return _table[steps - 1].color;
+
+    return color_blend(_table[index], _table[index + 1], position & 0xFF)
+        .color;
+  }
+
+  /**
+   * \brief Get the color at a given position of the gradient
+   * \param[in] level between 0 (start) and 1 (end)
+   */
+  uint32_t get_color(const float level) const {
+    return get_color16(constrain(level, 0.0f, 1.0f) * UINT16_MAX);
+  }
+
+ private:
+  void build() {
+    using ColorSpace::real_t;
+
+    real_t l[maxStops], a[maxStops], b[maxStops];
+    ColorSpace::rgb_to_oklab(_stops, _stopCount, l, a, b);
+
+    real_t tableL[steps], tableA[steps], tableB[steps];
+    const uint8_t lastSegment = _stopCount - 2;
+    for (uint16_t i = 0; i < steps; i++) {
+      // position of this step in the stop segments
+      const uint32_t position = uint32_t(i) * (_stopCount - 1);
+      uint8_t segment = position / (steps - 1);
+      uint16_t remainder = position % (steps - 1);
+      if (segment > lastSegment) {
+        segment = lastSegment;
+        remainder = steps - 1;
+      }
+      const real_t t = real_t(static_cast<int>(remainder)) /
+                       real_t(static_cast<int>(steps - 1));
+
+      tableL[i] = l[segment] + (l[segment + 1] - l[segment]) * t;
+      tableA[i] = a[segment] + (a[segment + 1] - a[segment]) * t;
+      tableB[i] = b[segment] + (b[segment + 1] - b[segment]) * t;
+    }
+    ColorSpace::oklab_to_rgb(tableL, tableA, tableB, steps, _table);
+
+    // the stops that fall on a step are copied, to skip the conversion error
+    for (uint8_t stop = 0; stop < _stopCount; stop++) {
+      const uint32_t position = uint32_t(stop) * (steps - 1);
+      if (position % (_stopCount - 1) == 0) {
+        _table[position / (_stopCount - 1)] = _stops[stop];
+      }
+    }
+  }
+
+  COLOR _table[steps];
+  COLOR _stops[maxStops];
+  uint8_t _stopCount;
+};
+
+}  // namespace utils
+
+#endif
@@ -0,0 +1,38 @@
+#include "kelvin.h"
+
+namespace utils::Kelvin {
+
+const WarmDimCurve warmDimTable =
+    make_warm_dim(Constexpr::MakeIndexSequence<256>());
+
+// blend two colors of a kelvin curve, fraction in [0, range]
+static COLOR16 interpolate(const KelvinCurve& curve, const uint8_t index,
+                           const uint16_t fraction, const uint16_t range) {
+  if (fraction == 0) return curve.values[index];
+  return color_blend(curve.values[index], curve.values[index + 1],
+                     (uint32_t(fraction) * UINT16_MAX) / range);
+}
+
+COLOR16 kelvin_to_rgb(const uint16_t kelvin, const int8_t tint) {
+  const uint16_t clampedKelvin = constrain(kelvin, minKelvin, maxKelvin);
+  const uint8_t index = (clampedKelvin - minKelvin) / kelvinStep;
+  const uint16_t fraction = (clampedKelvin - minKelvin) % kelvinStep;
+
+  const COLOR16 white =
+      interpolate(KelvinTable<0>::table, index, fraction, kelvinStep);
+  if (tint == 0) return white;
+
+  // blend towards the tinted table
+  const int8_t clampedTint = constrain(tint, -maxTint, maxTint);
+  const COLOR16 tinted =
+      (clampedTint > 0)
+          ? interpolate(KelvinTable<maxTint>::table, index, fraction,
+                        kelvinStep)
+          : interpolate(KelvinTable<-maxTint>::table, index, fraction,
+                        kelvinStep);
+  const uint8_t tintAmount = (clampedTint > 0) ? clampedTint : -clampedTint;
+  return color_blend(white, tinted,
+                     (uint32_t(tintAmount) * UINT16_MAX) / maxTint);
+}
+
+}  // namespace utils::Kelvin
@@ -0,0 +1,172 @@
+#ifndef KELVIN_H
+#define KELVIN_H
+
+#include <cstdint>
+
+#include "constexpr_utils.h"
+#include "utils.h"
+
+/// White of a given correlated color temperature (CCT).
+/// The blackbody colors are computed at compile time and stored in flash as 16
+/// bits sRGB colors, normalized to their brightest channel.
+namespace utils::Kelvin {
+
+constexpr uint16_t minKelvin = 1000;
+constexpr uint16_t maxKelvin = 10000;
+constexpr uint16_t kelvinStep = 100;
+constexpr uint16_t tableSize = (maxKelvin - minKelvin) / kelvinStep + 1;
+
+// tint (Duv) of the tinted tables, in thousandths
+constexpr int8_t maxTint = 20;
+
+// Planckian locus in CIE 1960 uv (Krystek approximation, 1000K to 15000K)
+constexpr double locus_u(const double t) {
+  return (0.860117757 + 1.54118254e-4 * t + 1.28641212e-7 * t * t) /
+         (1.0 + 8.42420235e-4 * t + 7.08145163e-7 * t * t);
+}
+
+constexpr double locus_v(const double t) {
+  return (0.317398726 + 4.22806245e-5 * t + 4.20481691e-8 * t * t) /
+         (1.0 - 2.89741816e-5 * t + 1.61456053e-7 * t * t);
+}
+
+// unit normal to the locus, pointing above it (towards green)
+constexpr double normal_norm(const double du, const double dv) {
+  return Constexpr::pow(du * du + dv * dv, 0.5);
+}
+
+constexpr double normal_u(const double t) {
+  return (locus_v(t + 1.0) - locus_v(t - 1.0)) /
+         normal_norm(locus_u(t + 1.0) - locus_u(t - 1.0),
+                     locus_v(t + 1.0) - locus_v(t - 1.0));
+}
+
+constexpr double normal_v(const double t) {
+  return -(locus_u(t + 1.0) - locus_u(t - 1.0)) /
+         normal_norm(locus_u(t + 1.0) - locus_u(t - 1.0),
+                     locus_v(t + 1.0) - locus_v(t - 1.0));
+}
+
+// chromaticity of the temperature t with a tint duv
+constexpr double u_of(const double t, const double duv) {
+  return locus_u(t) + duv * normal_u(t);
+}
+
+constexpr double v_of(const double t, const double duv) {
+  return locus_v(t) + duv * normal_v(t);
+}
+
+// uv to XYZ, for Y = 1
+constexpr double xyz_x(const double u, const double v) {
+  return 1.5 * u / v;
+}
+
+constexpr double xyz_z(const double u, const double v) {
+  return (4.0 - u - 10.0 * v) / (2.0 * v);
+}
+
+// XYZ to linear sRGB, negative values are clipped
+constexpr double positive(const double x) { return (x < 0.0) ? 0.0 : x; }
+
+constexpr double linear_channel(const double x, const double z,
+                                const uint8_t channel) {
+  return positive((channel == 0)   ? 3.2404542 * x - 1.5371385 - 0.4985314 * z
+                  : (channel == 1) ? -0.9692660 * x + 1.8760108 + 0.0415560 * z
+                                   : 0.0556434 * x - 0.2040259 + 1.0572252 * z);
+}
+
+constexpr double linear(const double t, const double duv,
+                        const uint8_t channel) {
+  return linear_channel(xyz_x(u_of(t, duv), v_of(t, duv)),
+                        xyz_z(u_of(t, duv), v_of(t, duv)), channel);
+}
+
+constexpr double max3(const double a, const double b, const double c) {
+  return (a > b) ? ((a > c) ? a : c) : ((b > c) ? b : c);
+}
+
+// sRGB transfer function
+constexpr double srgb_encode(const double c) {
+  return (c <= 0.0031308) ? 12.92 * c
+                          : 1.055 * Constexpr::pow(c, 1.0 / 2.4) - 0.055;
+}
+
+// channel of the temperature t, normalized to the brightest channel
+constexpr uint16_t channel_value(const double t, const double duv,
+                                 const uint8_t channel) {
+  return Constexpr::round_clamp(
+      srgb_encode(linear(t, duv, channel) /
+                  max3(linear(t, duv, 0), linear(t, duv, 1),
+                       linear(t, duv, 2))) *
+          65535.0,
+      0, 65535);
+}
+
+constexpr COLOR16 color_value(const double t, const double duv) {
+  return COLOR16{channel_value(t, duv, 2), channel_value(t, duv, 1),
+                 channel_value(t, duv, 0), 0};
+}
+
+/**
+ * \brief Blackbody colors, from minKelvin to maxKelvin by kelvinStep
+ */
+struct KelvinCurve {
+  COLOR16 values[tableSize];
+};
+
+template <size_t... I>
+constexpr KelvinCurve make_kelvin(Constexpr::IndexSequence<I...>,
+                                  const double duv) {
+  return KelvinCurve{
+      {color_value(minKelvin + I * double(kelvinStep), duv)...}};
+}
+
+template <int8_t tintX1000>
+struct KelvinTable {
+  static constexpr KelvinCurve table = make_kelvin(
+      Constexpr::MakeIndexSequence<tableSize>(), tintX1000 / 1000.0);
+};
+
+template <int8_t tintX1000>
+constexpr KelvinCurve KelvinTable<tintX1000>::table;
+
+/**
+ * \brief Warm dim: color temperature of a halogen lamp at a given brightness
+ * The temperature drops from 3000K at full brightness to 1800K when dimmed.
+ */
+constexpr double warm_dim_kelvin(const size_t brightness) {
+  return 1800.0 + 1200.0 * Constexpr::pow(brightness / 255.0, 0.5);
+}
+
+struct WarmDimCurve {
+  COLOR16 values[256];
+};
+
+template <size_t... I>
+constexpr WarmDimCurve make_warm_dim(Constexpr::IndexSequence<I...>) {
+  return WarmDimCurve{{color_value(warm_dim_kelvin(I), 0.0)...}};
+}
+
+// generated in kelvin.cpp, to compute it only once
+extern const WarmDimCurve warmDimTable;
+
+/**
+ * \brief White of a color temperature
+ * \param[in] kelvin between minKelvin and maxKelvin, clamped
+ * \param[in] tint Duv in thousandths, between -maxTint (pink) and maxTint
+ * (green)
+ * \return the white color, brightest channel at UINT16_MAX
+ */
+COLOR16 kelvin_to_rgb(const uint16_t kelvin, const int8_t tint = 0);
+
+/**
+ * \brief Warm dim white for a brightness (a single table read)
+ * \param[in] brightness 0 to 255
+ */
+inline const COLOR16& warm_dim(const uint8_t brightness) {
+  return warmDimTable.values[brightness];
+}
+
+}  // namespace utils::Kelvin
+
+#endif
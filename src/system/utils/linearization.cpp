@@ -0,0 +1,409 @@
+#include "linearization.h"
+
+#include <cmath>
+
+namespace utils::ColorSpace {
+
+// sRGB to linear transfer function, for each 8 bits channel value
+const real_t srgbToLinearTable[256] = {
+    0.0, 0.0003035269835488375, 0.000607053967097675, 0.0009105809506465125,
+    0.00121410793419535, 0.0015176349177441874, 0.001821161901293025,
+    0.0021246888848418626, 0.0024282158683907, 0.0027317428519395373,
+    0.003035269835488375, 0.003346535763899161, 0.003676507324047436,
+    0.004024717018496307, 0.004391442037410293, 0.004776953480693729,
+    0.005181516702338386, 0.005605391624202723, 0.006048833022857054,
+    0.006512090792594475, 0.006995410187265387, 0.007499032043226175,
+    0.008023192985384994, 0.008568125618069307, 0.009134058702220787,
+    0.00972121732023785, 0.010329823029626936, 0.010960094006488246,
+    0.011612245179743885, 0.012286488356915872, 0.012983032342173012,
+    0.013702083047289686, 0.014443843596092545, 0.01520851442291271,
+    0.01599629336550963, 0.016807375752887384, 0.017641954488384078,
+    0.018500220128379697, 0.019382360956935723, 0.0202885630566524,
+    0.021219010376003555, 0.02217388479338738, 0.02315336617811041,
+    0.024157632448504756, 0.02518685962736163, 0.026241221894849898,
+    0.027320891639074894, 0.028426039504420793, 0.0295568344378088,
+    0.030713443732993635, 0.03189603307301153, 0.033104766570885055,
+    0.03433980680868217, 0.03560131487502034, 0.03688945040110004,
+    0.0382043715953465, 0.03954623527673284, 0.04091519690685319,
+    0.042311410620809675, 0.043735029256973465, 0.04518620438567554,
+    0.046665086336880095, 0.04817182422688942, 0.04970656598412723,
+    0.05126945837404324, 0.052860647023180246, 0.05448027644244237,
+    0.05612849004960009, 0.05780543019106723, 0.0595112381629812,
+    0.06124605423161761, 0.06301001765316767, 0.06480326669290577,
+    0.06662593864377289, 0.06847816984440017, 0.07036009569659588,
+    0.07227185068231748, 0.07421356838014963, 0.07618538148130785,
+    0.07818742180518633, 0.08021982031446832, 0.0822827071298148,
+    0.08437621154414882, 0.08650046203654976, 0.08865558628577294,
+    0.09084171118340768, 0.09305896284668745, 0.0953074666309647,
+    0.09758734714186246, 0.09989872824711389, 0.10224173308810132,
+    0.10461648409110419, 0.10702310297826761, 0.10946171077829933,
+    0.1119324278369056, 0.11443537382697373, 0.11697066775851084,
+    0.11953842798834562, 0.12213877222960187, 0.12477181756095049,
+    0.12743768043564743, 0.1301364766903643, 0.13286832155381798,
+    0.13563332965520566, 0.13843161503245183, 0.14126329114027164,
+    0.14412847085805777, 0.14702726649759498, 0.14995978981060856,
+    0.15292615199615017, 0.1559264637078274, 0.1589608350608804,
+    0.162029375639111, 0.1651321945016676, 0.16826940018969075,
+    0.1714411007328226, 0.17464740365558504, 0.17788841598362912,
+    0.18116424424986022, 0.184474994500441, 0.18782077230067787,
+    0.19120168274079138, 0.1946178304415758, 0.19806931955994886,
+    0.20155625379439707, 0.20507873639031693, 0.20863687014525575,
+    0.21223075741405523, 0.21586050011389926, 0.2195261997292692,
+    0.2232279573168085, 0.22696587351009836, 0.23074004852434915,
+    0.23455058216100522, 0.238397573812271, 0.24228112246555486,
+    0.24620132670783548, 0.25015828472995344, 0.25415209433082675,
+    0.2581828529215958, 0.26225065752969623, 0.26635560480286247,
+    0.2704977910130658, 0.27467731206038465, 0.2788942634768104,
+    0.2831487404299921, 0.2874408377269175, 0.29177064981753587,
+    0.2961382707983211, 0.3005437944157765, 0.3049873140698863,
+    0.30946892281750854, 0.31398871337571754, 0.31854677812509186,
+    0.32314320911295075, 0.3277780980565422, 0.33245153634617935,
+    0.33716361504833037, 0.3419144249086609, 0.3467040563550296,
+    0.35153259950043936, 0.3564001441459435, 0.3613067797835095,
+    0.3662525955988395, 0.3712376804741491, 0.3762621229909065,
+    0.38132601143253014, 0.386429433787049, 0.39157247774972326,
+    0.39675523072562685, 0.4019777798321958, 0.4072402119017367,
+    0.41254261348390375, 0.4178850708481375, 0.4232676699860717,
+    0.4286904966139066, 0.43415363617474895, 0.4396571738409188,
+    0.44520119451622786, 0.45078578283822346, 0.45641102318040466,
+    0.4620769996544071, 0.467783796112159, 0.47353149614800955,
+    0.4793201831008268, 0.4851499400560704, 0.4910208498478356,
+    0.4969329950608704, 0.5028864580325687, 0.5088813208549338,
+    0.5149176653765214, 0.5209955732043543, 0.5271151257058131,
+    0.5332764040105052, 0.5394794890121072, 0.5457244613701866,
+    0.5520114015120001, 0.5583403896342679, 0.5647115057049292,
+    0.5711248294648731, 0.5775804404296506, 0.5840784178911641,
+    0.5906188409193369, 0.5972017883637634, 0.6038273388553378,
+    0.6104955708078648, 0.6172065624196511, 0.6239603916750761,
+    0.6307571363461468, 0.6375968739940326, 0.6444796819705821,
+    0.6514056374198242, 0.6583748172794485, 0.665387298282272,
+    0.6724431569576875, 0.6795424696330938, 0.6866853124353135,
+    0.6938717612919899, 0.7011018919329731, 0.7083757798916868,
+    0.7156935005064807, 0.7230551289219693, 0.7304607400903537,
+    0.7379104087727308, 0.7454042095403874, 0.7529422167760779,
+    0.7605245046752924, 0.768151147247507, 0.7758222183174236,
+    0.7835377915261935, 0.7912979403326302, 0.799102738014409,
+    0.8069522576692516, 0.8148465722161012, 0.8227857543962835,
+    0.8307698767746546, 0.83879901174074, 0.846873231509858, 0.8549926081242338,
+    0.8631572134541023, 0.8713671191987972, 0.8796223968878317,
+    0.8879231178819663, 0.8962693533742664, 0.9046611743911496,
+    0.9130986517934192, 0.9215818562772946, 0.9301108583754237,
+    0.938685728457888, 0.9473065367331999, 0.9559733532492861,
+    0.9646862478944651, 0.9734452903984125, 0.9822505503331171,
+    0.9911020971138298, 1.0};
+
+// linear to sRGB transfer function, rounded to the nearest 8 bits value.
+// Indexed by the linear value on 12 bits, the steepest slope (near 0) is 0.8
+// channel value per index so the result is never off by more than one.
+const uint8_t linearToSrgbTable[linearToSrgbSize] = {
+      0,   1,   2,   2,   3,   4,   5,   6,   6,   7,   8,   9,  10,  10,  11,
+     12,  13,  13,  14,  15,  15,  16,  16,  17,  18,  18,  19,  19,  20,  20,
+     21,  21,  22,  22,  23,  23,  23,  24,  24,  25,  25,  25,  26,  26,  27,
+     27,  27,  28,  28,  29,  29,  29,  30,  30,  30,  31,  31,  31,  32,  32,
+     32,  33,  33,  33,  34,  34,  34,  34,  35,  35,  35,  36,  36,  36,  37,
+     37,  37,  37,  38,  38,  38,  38,  39,  39,  39,  40,  40,  40,  40,  41,
+     41,  41,  41,  42,  42,  42,  42,  43,  43,  43,  43,  43,  44,  44,  44,
+     44,  45,  45,  45,  45,  46,  46,  46,  46,  46,  47,  47,  47,  47,  48,
+     48,  48,  48,  48,  49,  49,  49,  49,  49,  50,  50,  50,  50,  50,  51,
+     51,  51,  51,  51,  52,  52,  52,  52,  52,  53,  53,  53,  53,  53,  54,
+     54,  54,  54,  54,  55,  55,  55,  55,  55,  55,  56,  56,  56,  56,  56,
+     57,  57,  57,  57,  57,  57,  58,  58,  58,  58,  58,  58,  59,  59,  59,
+     59,  59,  59,  60,  60,  60,  60,  60,  60,  61,  61,  61,  61,  61,  61,
+     62,  62,  62,  62,  62,  62,  63,  63,  63,  63,  63,  63,  64,  64,  64,
+     64,  64,  64,  64,  65,  65,  65,  65,  65,  65,  66,  66,  66,  66,  66,
+     66,  66,  67,  67,  67,  67,  67,  67,  67,  68,  68,  68,  68,  68,  68,
+     68,  69,  69,  69,  69,  69,  69,  69,  70,  70,  70,  70,  70,  70,  70,
+     71,  71,  71,  71,  71,  71,  71,  72,  72,  72,  72,  72,  72,  72,  72,
+     73,  73,  73,  73,  73,  73,  73,  74,  74,  74,  74,  74,  74,  74,  74,
+     75,  75,  75,  75,  75,  75,  75,  75,  76,  76,  76,  76,  76,  76,  76,
+     77,  77,  77,  77,  77,  77,  77,  77,  78,  78,  78,  78,  78,  78,  78,
+     78,  78,  79,  79,  79,  79,  79,  79,  79,  79,  80,  80,  80,  80,  80,
+     80,  80,  80,  81,  81,  81,  81,  81,  81,  81,  81,  81,  82,  82,  82,
+     82,  82,  82,  82,  82,  83,  83,  83,  83,  83,  83,  83,  83,  83,  84,
+     84,  84,  84,  84,  84,  84,  84,  84,  85,  85,  85,  85,  85,  85,  85,
+     85,  85,  86,  86,  86,  86,  86,  86,  86,  86,  86,  87,  87,  87,  87,
+     87,  87,  87,  87,  87,  88,  88,  88,  88,  88,  88,  88,  88,  88,  88,
+     89,  89,  89,  89,  89,  89,  89,  89,  89,  90,  90,  90,  90,  90,  90,
+     90,  90,  90,  90,  91,  91,  91,  91,  91,  91,  91,  91,  91,  91,  92,
+     92,  92,  92,  92,  92,  92,  92,  92,  92,  93,  93,  93,  93,  93,  93,
+     93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  95,
+     95,  95,  95,  95,  95,  95,  95,  95,  95,  96,  96,  96,  96,  96,  96,
+     96,  96,  96,  96,  96,  97,  97,  97,  97,  97,  97,  97,  97,  97,  97,
+     98,  98,  98,  98,  98,  98,  98,  98,  98,  98,  98,  99,  99,  99,  99,
+     99,  99,  99,  99,  99,  99,  99, 100, 100, 100, 100, 100, 100, 100, 100,
+    100, 100, 100, 101, 101, 101, 101, 101, 101, 101, 101, 101, 101, 101, 102,
+    102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 103, 103, 103, 103, 103,
+    103, 103, 103, 103, 103, 103, 103, 104, 104, 104, 104, 104, 104, 104, 104,
+    104, 104, 104, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105,
+    106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 107, 107, 107,
+    107, 107, 107, 107, 107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108,
+    108, 108, 108, 108, 108, 108, 109, 109, 109, 109, 109, 109, 109, 109, 109,
+    109, 109, 109, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+    111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 112, 112,
+    112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 113, 113, 113, 113, 113,
+    113, 113, 113, 113, 113, 113, 113, 113, 114, 114, 114, 114, 114, 114, 114,
+    114, 114, 114, 114, 114, 114, 115, 115, 115, 115, 115, 115, 115, 115, 115,
+    115, 115, 115, 115, 116, 116, 116, 116, 116, 116, 116, 116, 116, 116, 116,
+    116, 116, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117,
+    117, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 119,
+    119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 120, 120,
+    120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 121, 121, 121,
+    121, 121, 121, 121, 121, 121, 121, 121, 121, 121, 122, 122, 122, 122, 122,
+    122, 122, 122, 122, 122, 122, 122, 122, 122, 122, 123, 123, 123, 123, 123,
+    123, 123, 123, 123, 123, 123, 123, 123, 123, 124, 124, 124, 124, 124, 124,
+    124, 124, 124, 124, 124, 124, 124, 124, 125, 125, 125, 125, 125, 125, 125,
+    125, 125, 125, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 126, 126,
+    126, 126, 126, 126, 126, 126, 126, 127, 127, 127, 127, 127, 127, 127, 127,
+    127, 127, 127, 127, 127, 127, 127, 128, 128, 128, 128, 128, 128, 128, 128,
+    128, 128, 128, 128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, 129,
+    129, 129, 129, 129, 129, 129, 129, 130, 130, 130, 130, 130, 130, 130, 130,
+    130, 130, 130, 130, 130, 130, 130, 131, 131, 131, 131, 131, 131, 131, 131,
+    131, 131, 131, 131, 131, 131, 131, 131, 132, 132, 132, 132, 132, 132, 132,
+    132, 132, 132, 132, 132, 132, 132, 132, 133, 133, 133, 133, 133, 133, 133,
+    133, 133, 133, 133, 133, 133, 133, 133, 133, 134, 134, 134, 134, 134, 134,
+    134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, 135,
+    135, 135, 135, 135, 135, 135, 135, 135, 135, 135, 135, 136, 136, 136, 136,
+    136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 137, 137, 137,
+    137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 138, 138,
+    138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 139,
+    139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139,
+    139, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140,
+    140, 140, 140, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141,
+    141, 141, 141, 141, 141, 142, 142, 142, 142, 142, 142, 142, 142, 142, 142,
+    142, 142, 142, 142, 142, 142, 142, 143, 143, 143, 143, 143, 143, 143, 143,
+    143, 143, 143, 143, 143, 143, 143, 143, 143, 144, 144, 144, 144, 144, 144,
+    144, 144, 144, 144, 144, 144, 144, 144, 144, 144, 144, 145, 145, 145, 145,
+    145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 146,
+    146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146,
+    146, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147,
+    147, 147, 147, 147, 148, 148, 148, 148, 148, 148, 148, 148, 148, 148, 148,
+    148, 148, 148, 148, 148, 148, 148, 149, 149, 149, 149, 149, 149, 149, 149,
+    149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 150, 150, 150, 150, 150,
+    150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 151,
+    151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151,
+    151, 151, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152,
+    152, 152, 152, 152, 152, 152, 153, 153, 153, 153, 153, 153, 153, 153, 153,
+    153, 153, 153, 153, 153, 153, 153, 153, 153, 154, 154, 154, 154, 154, 154,
+    154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 155, 155,
+    155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155,
+    155, 155, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156,
+    156, 156, 156, 156, 156, 156, 156, 157, 157, 157, 157, 157, 157, 157, 157,
+    157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 158, 158, 158, 158,
+    158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158,
+    159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159,
+    159, 159, 159, 159, 159, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160,
+    160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 161, 161, 161, 161, 161,
+    161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161,
+    162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162,
+    162, 162, 162, 162, 162, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163,
+    163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 164, 164, 164, 164, 164,
+    164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164,
+    164, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165,
+    165, 165, 165, 165, 165, 165, 165, 166, 166, 166, 166, 166, 166, 166, 166,
+    166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 167, 167, 167,
+    167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167,
+    167, 167, 167, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168,
+    168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 169, 169, 169, 169, 169,
+    169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169,
+    169, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170,
+    170, 170, 170, 170, 170, 170, 170, 171, 171, 171, 171, 171, 171, 171, 171,
+    171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 172,
+    172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172,
+    172, 172, 172, 172, 172, 172, 173, 173, 173, 173, 173, 173, 173, 173, 173,
+    173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 174, 174,
+    174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174,
+    174, 174, 174, 174, 174, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175,
+    175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 176, 176, 176,
+    176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176,
+    176, 176, 176, 176, 176, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177,
+    177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 178, 178, 178,
+    178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178,
+    178, 178, 178, 178, 178, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179,
+    179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 180, 180,
+    180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180,
+    180, 180, 180, 180, 180, 180, 181, 181, 181, 181, 181, 181, 181, 181, 181,
+    181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 182,
+    182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182,
+    182, 182, 182, 182, 182, 182, 182, 182, 183, 183, 183, 183, 183, 183, 183,
+    183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183,
+    183, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184,
+    184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 185, 185, 185, 185, 185,
+    185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185,
+    185, 185, 185, 185, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186,
+    186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 187, 187,
+    187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187,
+    187, 187, 187, 187, 187, 187, 187, 187, 188, 188, 188, 188, 188, 188, 188,
+    188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188,
+    188, 188, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189,
+    189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 190, 190, 190,
+    190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190,
+    190, 190, 190, 190, 190, 190, 190, 191, 191, 191, 191, 191, 191, 191, 191,
+    191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191,
+    191, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192,
+    192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 193, 193, 193,
+    193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193,
+    193, 193, 193, 193, 193, 193, 193, 194, 194, 194, 194, 194, 194, 194, 194,
+    194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194,
+    194, 194, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195,
+    195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 196, 196,
+    196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196,
+    196, 196, 196, 196, 196, 196, 196, 196, 196, 197, 197, 197, 197, 197, 197,
+    197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197,
+    197, 197, 197, 197, 197, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+    198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198,
+    198, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199,
+    199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 200, 200, 200,
+    200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200,
+    200, 200, 200, 200, 200, 200, 200, 200, 200, 201, 201, 201, 201, 201, 201,
+    201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201,
+    201, 201, 201, 201, 201, 201, 202, 202, 202, 202, 202, 202, 202, 202, 202,
+    202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202,
+    202, 202, 202, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203,
+    203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203,
+    204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204,
+    204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 205, 205, 205,
+    205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205,
+    205, 205, 205, 205, 205, 205, 205, 205, 205, 206, 206, 206, 206, 206, 206,
+    206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206,
+    206, 206, 206, 206, 206, 206, 206, 207, 207, 207, 207, 207, 207, 207, 207,
+    207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207,
+    207, 207, 207, 207, 207, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208,
+    208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208,
+    208, 208, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209,
+    209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209,
+    209, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210,
+    210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 211,
+    211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211,
+    211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 212, 212, 212,
+    212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212,
+    212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 213, 213, 213, 213,
+    213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213,
+    213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 214, 214, 214, 214, 214,
+    214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214,
+    214, 214, 214, 214, 214, 214, 214, 214, 214, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215,
+    215, 215, 215, 215, 215, 215, 215, 215, 216, 216, 216, 216, 216, 216, 216,
+    216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216,
+    216, 216, 216, 216, 216, 216, 216, 217, 217, 217, 217, 217, 217, 217, 217,
+    217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217,
+    217, 217, 217, 217, 217, 217, 217, 218, 218, 218, 218, 218, 218, 218, 218,
+    218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218,
+    218, 218, 218, 218, 218, 218, 219, 219, 219, 219, 219, 219, 219, 219, 219,
+    219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219,
+    219, 219, 219, 219, 219, 219, 220, 220, 220, 220, 220, 220, 220, 220, 220,
+    220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220,
+    220, 220, 220, 220, 220, 220, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+    221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221,
+    221, 221, 221, 221, 221, 221, 221, 222, 222, 222, 222, 222, 222, 222, 222,
+    222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222,
+    222, 222, 222, 222, 222, 222, 222, 223, 223, 223, 223, 223, 223, 223, 223,
+    223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223,
+    223, 223, 223, 223, 223, 223, 223, 223, 224, 224, 224, 224, 224, 224, 224,
+    224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224,
+    224, 224, 224, 224, 224, 224, 224, 224, 225, 225, 225, 225, 225, 225, 225,
+    225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225,
+    225, 225, 225, 225, 225, 225, 225, 225, 225, 226, 226, 226, 226, 226, 226,
+    226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226,
+    226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 227, 227, 227, 227, 227,
+    227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227,
+    227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 228, 228, 228,
+    228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228,
+    228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 229, 229,
+    229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+    229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229,
+    230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+    230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230,
+    230, 230, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+    231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231,
+    231, 231, 231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+    232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+    232, 232, 232, 232, 232, 232, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+    233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+    233, 233, 233, 233, 233, 233, 233, 233, 233, 234, 234, 234, 234, 234, 234,
+    234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+    234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 235, 235, 235, 235,
+    235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235,
+    235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 236,
+    236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+    236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236,
+    236, 236, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+    237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237,
+    237, 237, 237, 237, 237, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238,
+    238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238,
+    238, 238, 238, 238, 238, 238, 238, 238, 239, 239, 239, 239, 239, 239, 239,
+    239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239,
+    239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 240, 240, 240,
+    240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+    240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240,
+    240, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+    241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241,
+    241, 241, 241, 241, 241, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242,
+    242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242,
+    242, 242, 242, 242, 242, 242, 242, 242, 242, 243, 243, 243, 243, 243, 243,
+    243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243,
+    243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 244, 244,
+    244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244,
+    244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244,
+    244, 244, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+    245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+    245, 245, 245, 245, 245, 245, 245, 246, 246, 246, 246, 246, 246, 246, 246,
+    246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246,
+    246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 247, 247, 247,
+    247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247,
+    247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247,
+    247, 247, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+    248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248,
+    248, 248, 248, 248, 248, 248, 248, 249, 249, 249, 249, 249, 249, 249, 249,
+    249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249,
+    249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 250, 250, 250,
+    250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+    250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250,
+    250, 250, 250, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251,
+    251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251,
+    251, 251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252, 252, 252,
+    252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+    252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252,
+    253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+    253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253,
+    253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+    254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254,
+    254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255};
+
+uint8_t from_linear(const real_t linear) {
+  static constexpr real_t zero = real_t(0.0);
+  static constexpr real_t one = real_t(1.0);
+  static constexpr real_t indexScale = real_t(linearToSrgbSize - 1.0);
+  static constexpr real_t half = real_t(0.5);
+
+  if (linear <= zero) return 0;
+  if (linear >= one) return 255;
+  return linearToSrgbTable[static_cast<int>(linear * indexScale + half)];
+}
+
+real_t to_linear_exact(const real_t srgb) {
+  using std::pow;
+  static constexpr real_t threshold = real_t(0.04045);
+  static constexpr real_t invSlope = real_t(1.0 / 12.92);
+  static constexpr real_t offset = real_t(0.055);
+  static constexpr real_t invScale = real_t(1.0 / 1.055);
+  static constexpr real_t exponent = real_t(2.4);
+
+  return (srgb > threshold) ? pow((srgb + offset) * invScale, exponent)
+                            : (srgb * invSlope);
+}
+
+real_t from_linear_exact(const real_t linear) {
+  using std::pow;
+  static constexpr real_t threshold = real_t(0.0031308);
+  static constexpr real_t slope = real_t(12.92);
+  static constexpr real_t offset = real_t(0.055);
+  static constexpr real_t scale = real_t(1.055);
+  static constexpr real_t invExponent = real_t(1.0 / 2.4);
+
+  return (linear > threshold) ? (scale * pow(linear, invExponent) - offset)
+                              : (slope * linear);
+}
+
+}  // namespace utils::ColorSpace
@@ -0,0 +1,43 @@
+#ifndef LINEARIZATION_H
+#define LINEARIZATION_H
+
+#include <cstdint>
+
+#include "color_precision.h"
+
+/// sRGB transfer functions, shared by all the colorspace conversions.
+/// The 8 bits versions are table reads, no pow call at runtime.
+namespace utils::ColorSpace {
+
+// size of the linear to sRGB table (12 bits index)
+constexpr uint16_t linearToSrgbSize = 4096;
+
+extern const real_t srgbToLinearTable[256];
+extern const uint8_t linearToSrgbTable[linearToSrgbSize];
+
+/**
+ * \brief Convert an 8 bits sRGB channel to a linear value
+ * \param[in] channel The sRGB channel value
+ * \return the linear light intensity, between 0 and 1
+ */
+inline real_t to_linear(const uint8_t channel) {
+  return srgbToLinearTable[channel];
+}
+
+/**
+ * \brief Convert a linear value to the nearest 8 bits sRGB channel
+ * \param[in] linear The linear light intensity, clamped between 0 and 1
+ * \return the sRGB channel value
+ */
+uint8_t from_linear(const real_t linear);
+
+/**
+ * \brief Exact transfer functions, for unquantized sRGB values (slower)
+ * \param[in] value between 0 and 1
+ */
+real_t to_linear_exact(const real_t srgb);
+real_t from_linear_exact(const real_t linear);
+
+}  // namespace utils::ColorSpace
+
+#endif
@@ -0,0 +1,129 @@
+#include "profiler.h"
+
+namespace profiler {
+
+static constexpr uint8_t stageCount = static_cast<uint8_t>(Stage::COUNT);
+
+// log histogram: 4 buckets per power of two, for durations up to 2^32 ticks
+static constexpr uint8_t subBucketBits = 2;
+static constexpr uint8_t subBuckets = 1 << subBucketBits;
+static constexpr uint8_t bucketCount = (32 - subBucketBits + 1) * subBuckets;
+
+struct StageData {
+  uint32_t count;
+  uint64_t total;
+  uint32_t min;
+  uint32_t max;
+  uint16_t histogram[bucketCount];
+};
+
+static StageData stages[stageCount];
+
+static uint8_t bucket_of(const uint32_t ticks) {
+  if (ticks < subBuckets) return ticks;
+
+  const uint8_t msb = 31 - __builtin_clz(ticks);
+  const uint8_t sub = (ticks >> (msb - subBucketBits)) & (subBuckets - 1);
+  return (msb - subBucketBits + 1) * subBuckets + sub;
+}
+
+// highest duration stored in a bucket
+static uint32_t bucket_upper_bound(const uint8_t bucket) {
+  if (bucket < subBuckets) return bucket;
+
+  const uint8_t shift = bucket / subBuckets - 1;
+  const uint32_t lower = uint32_t(subBuckets + bucket % subBuckets) << shift;
+  return lower + ((uint32_t(1) << shift) - 1);
+}
+
+void setup() {
+#ifdef ARDUINO
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  reset();
+}
+
+void add_sample(const Stage stage, const uint32_t ticks) {
+  StageData& data = stages[static_cast<uint8_t>(stage)];
+  if (data.count == 0 or ticks < data.min) data.min = ticks;
+  if (ticks > data.max) data.max = ticks;
+  data.count++;
+  data.total += ticks;
+
+  uint16_t& bucketValue = data.histogram[bucket_of(ticks)];
+  if (bucketValue == UINT16_MAX) {
+    // halve the histogram, it keeps the distribution
+    for (uint16_t& value : data.histogram) value >>= 1;
+  }
+  bucketValue++;
+}
+
+Statistics get_statistics(const Stage stage) {
+  const StageData& data = stages[static_cast<uint8_t>(stage)];
+  Statistics statistics = {data.count, 0.0, 0.0, 0.0, 0.0};
+  if (data.count == 0) return statistics;
+
+  statistics.min_us = data.min / ticksPerMicrosecond;
+  statistics.average_us = (data.total / data.count) / ticksPerMicrosecond;
+  statistics.max_us = data.max / ticksPerMicrosecond;
+
+  // the histogram may have been halved: use its own total
+  uint32_t histogramTotal = 0;
+  for (const uint16_t value : data.histogram) histogramTotal += value;
+
+  // first bucket that leaves at most 1% of the samples above it
+  const uint32_t threshold = histogramTotal - histogramTotal / 100;
+  uint32_t cumulated = 0;
+  for (uint8_t bucket = 0; bucket < bucketCount; ++bucket) {
+    cumulated += data.histogram[bucket];
+    if (cumulated >= threshold) {
+      // the bucket bound can exceed the real max
+      const uint32_t p99 = bucket_upper_bound(bucket);
+      statistics.p99_us = ((p99 < data.max) ? p99 : data.max) /
+                          ticksPerMicrosecond;
+      break;
+    }
+  }
+  return statistics;
+}
+
+const char* get_name(const Stage stage) {
+  switch (stage) {
+    case Stage::BUTTON:
+      return "button";
+    case Stage::DISPLAY:
+      return "display";
+    case Stage::SERIAL_CLI:
+      return "serial";
+    case Stage::USER:
+      return "user";
+    case Stage::TEMPERATURE:
+      return "temperature";
+    case Stage::BATTERY:
+      return "battery";
+    case Stage::BLUETOOTH:
+      return "bluetooth";
+    case Stage::ALERTS:
+      return "alerts";
+    case Stage::SENSORS:
+      return "sensors";
+    case Stage::FRAME:
+      return "frame";
+    default:
+      return "unknown";
+  }
+}
+
+void reset() {
+  for (StageData& data : stages) {
+    data.count = 0;
+    data.total = 0;
+    data.min = 0;
+    data.max = 0;
+    for (uint16_t& value : data.histogram) value = 0;
+  }
+}
+
+}  // namespace profiler
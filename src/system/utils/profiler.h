@@ -0,0 +1,94 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+/// Execution time of the main loop stages, measured with the cycle counter.
+/// Each stage keeps its min, average, max and a log histogram (for the 99th
+/// percentile) in a fixed RAM space.
+namespace profiler {
+
+enum class Stage : uint8_t {
+  BUTTON = 0,   // button reading
+  DISPLAY,      // button actions and color frames
+  SERIAL_CLI,   // serial commands
+  USER,         // user loop
+  TEMPERATURE,  // thermal derating and temperature alerts
+  BATTERY,      // battery alerts and current limiter
+  BLUETOOTH,    // bluetooth messages
+  ALERTS,       // alert display and charger
+  SENSORS,      // sensor auto disable
+  FRAME,        // period between two user loop frames
+
+  COUNT
+};
+
+#ifdef ARDUINO
+// cycle counter of the cortex M4
+constexpr float ticksPerMicrosecond = F_CPU / 1000000.0;
+inline uint32_t get_ticks() { return DWT->CYCCNT; }
+#else
+// host fallback: nanoseconds
+constexpr float ticksPerMicrosecond = 1000.0;
+inline uint32_t get_ticks() {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+#endif
+
+struct Statistics {
+  uint32_t count;  // number of samples
+  float min_us;
+  float average_us;
+  float max_us;
+  float p99_us;  // upper bound of the 99th percentile (12% precision)
+};
+
+/**
+ * \brief Start the cycle counter
+ */
+void setup();
+
+/**
+ * \brief Add a duration sample to a stage
+ * \param[in] ticks duration of the stage (get_ticks() difference)
+ */
+void add_sample(const Stage stage, const uint32_t ticks);
+
+// statistics of a stage, since the last reset
+Statistics get_statistics(const Stage stage);
+
+// name of a stage, for display
+const char* get_name(const Stage stage);
+
+// clear the statistics of all stages
+void reset();
+
+/**
+ * \brief Measure the duration of the enclosing scope
+ */
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const Stage stage)
+      : _stage(stage), _start(get_ticks()) {}
+  ~ScopedTimer() { add_sample(_stage, get_ticks() - _start); }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  const Stage _stage;
+  const uint32_t _start;
+};
+
+}  // namespace profiler
+
+#endif
@@ -0,0 +1,57 @@
+#include "ramp.h"
+
+namespace utils {
+
+// easing curve, progress in [0, 1]
+static float ease(const float progress, const Ramp::Easing easing) {
+  switch (easing) {
+    case Ramp::Easing::InOutQuad:
+      return (progress < 0.5f)
+                 ? 2.0f * progress * progress
+                 : 1.0f - 2.0f * (1.0f - progress) * (1.0f - progress);
+    case Ramp::Easing::InOutCubic: {
+      if (progress < 0.5f) return 4.0f * progress * progress * progress;
+      const float remaining = 2.0f - 2.0f * progress;
+      return 1.0f - remaining * remaining * remaining / 2.0f;
+    }
+    default:  // Linear
+      return progress;
+  }
+}
+
+Ramp::Ramp() : _startTime(0), _durationMs(0) {
+  for (uint16_t& level : _table) level = 0;
+}
+
+void Ramp::start(const uint16_t from, const uint16_t to,
+                 const uint32_t durationMs, const Easing easing,
+                 const uint32_t startTime) {
+  const float delta = float(to) - float(from);
+  for (uint8_t i = 0; i <= segments; i++) {
+    _table[i] = from + delta * ease(i / float(segments), easing) + 0.5f;
+  }
+  _table[segments] = to;
+
+  _startTime = startTime;
+  _durationMs = durationMs;
+}
+
+uint16_t Ramp::get(const uint32_t time) const {
+  if (is_finished(time)) return _table[segments];
+
+  // position in the table, with 8 bits of fraction
+  const uint32_t position =
+      (uint64_t(time - _startTime) * (segments << 8)) / _durationMs;
+  const uint8_t index = position >> 8;
+  const int32_t fraction = position & 0xFF;
+
+  const int32_t a = _table[index];
+  const int32_t b = _table[index + 1];
+  return a + (((b - a) * fraction) >> 8);
+}
+
+bool Ramp::is_finished(const uint32_t time) const {
+  return (time - _startTime) >= _durationMs;
+}
+
+}  // namespace utils
@@ -0,0 +1,53 @@
+#ifndef RAMP_H
+#define RAMP_H
+
+#include <cstdint>
+
+namespace utils {
+
+/**
+ * \brief Ramp between two levels, with an easing curve.
+ * The eased curve is precomputed once in a table when the ramp starts. The
+ * level is then a function of the time since the start (table read and
+ * interpolation), so the ramp does not depend on how regularly it is read.
+ */
+class Ramp {
+ public:
+  enum class Easing : uint8_t {
+    Linear,
+    InOutQuad,
+    InOutCubic,
+  };
+
+  Ramp();
+
+  /**
+   * \brief Start a new ramp
+   * \param[in] from start level
+   * \param[in] to end level
+   * \param[in] durationMs duration of the ramp, in milliseconds
+   * \param[in] easing the shape of the ramp
+   * \param[in] startTime time of the start of the ramp, in milliseconds
+   */
+  void start(const uint16_t from, const uint16_t to, const uint32_t durationMs,
+             const Easing easing, const uint32_t startTime);
+
+  /**
+   * \brief Level of the ramp at a given time
+   * \param[in] time in milliseconds, same clock as startTime
+   */
+  uint16_t get(const uint32_t time) const;
+
+  bool is_finished(const uint32_t time) const;
+
+ private:
+  static constexpr uint8_t segments = 32;
+
+  uint16_t _table[segments + 1];
+  uint32_t _startTime;
+  uint32_t _durationMs;
+};
+
+}  // namespace utils
+
+#endif
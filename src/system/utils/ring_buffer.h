@@ -0,0 +1,129 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace utils {
+
+/**
+ * \brief Lock free single producer, single consumer ring buffer.
+ * One side (an interrupt) pushes, the other side (a thread) pops, without
+ * disabling the interrupts. The producer never overwrites an element that the
+ * consumer did not release: when the buffer is full, the new element is
+ * dropped and counted.
+ * \param T the element type
+ * \param capacity number of elements, a power of two
+ */
+template <typename T, uint16_t capacity>
+class RingBuffer {
+  static_assert(capacity > 0 and (capacity & (capacity - 1)) == 0,
+                "capacity must be a power of two");
+
+ public:
+  RingBuffer() : _head(0), _tail(0), _dropped(0) {}
+
+  // producer side
+
+  /**
+   * \brief Add an element
+   * \return false if the buffer is full (the element is dropped)
+   */
+  bool push(const T& value) {
+    T* slot = begin_push();
+    if (slot == nullptr) return false;
+    *slot = value;
+    end_push();
+    return true;
+  }
+
+  /**
+   * \brief Get the next free element, to fill it in place
+   * \return nullptr if the buffer is full (counted as dropped). Else, call
+   * end_push to publish the element
+   */
+  T* begin_push() {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= capacity) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &_buffer[head & mask];
+  }
+
+  void end_push() {
+    _head.store(_head.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // consumer side
+
+  /**
+   * \brief Remove the oldest element
+   * \return false if the buffer is empty
+   */
+  bool pop(T& value) {
+    const T* oldest = front();
+    if (oldest == nullptr) return false;
+    value = *oldest;
+    pop_front();
+    return true;
+  }
+
+  /**
+   * \brief Oldest element, read in place. It stays valid until pop_front
+   * \return nullptr if the buffer is empty
+   */
+  const T* front() const {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+    return &_buffer[tail & mask];
+  }
+
+  // release the oldest element, the buffer must not be empty
+  void pop_front() {
+    _tail.store(_tail.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // release all the elements
+  void clear() {
+    _tail.store(_head.load(std::memory_order_acquire),
+                std::memory_order_release);
+  }
+
+  // either side
+
+  uint16_t size() const {
+    return _head.load(std::memory_order_acquire) -
+           _tail.load(std::memory_order_acquire);
+  }
+  bool is_empty() const { return size() == 0; }
+
+  // number of elements dropped because the buffer was full
+  uint32_t get_dropped_count() const {
+    return _dropped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t mask = capacity - 1;
+
+  T _buffer[capacity];
+  // free running indexes, written by a single side each
+  std::atomic<uint32_t> _head;  // producer
+  std::atomic<uint32_t> _tail;  // consumer
+  std::atomic<uint32_t> _dropped;
+};
+
+/**
+ * \brief An event value and its time of arrival
+ */
+template <typename T>
+struct TimedEvent {
+  uint32_t time;  // millis
+  T value;
+};
+
+}  // namespace utils
+
+#endif
@@ -3,9 +3,15 @@
 #include <Arduino.h>
 
 #include "../../user_constants.h"
+#include "../alerts.h"
+#include "../charge_idle.h"
 #include "../charger/charger.h"
 #include "../physical/battery.h"
+#include "../thermal.h"
 #include "constants.h"
+#include "profiler.h"
+#include "soc.h"
+#include "tracer.h"
 
 namespace serial {
 
@@ -30,7 +36,16 @@ void handleCommand(const String& command) {
       Serial.println("h: this page");
       Serial.println("v: hardware & software version");
       Serial.println("bl: battery level");
+      Serial.println("soc: battery state of charge estimation");
+      Serial.println("soclog: toggle the state of charge inputs logging");
       Serial.println("vbus: USB voltage bus infos");
+      Serial.println("temp: temperatures and thermal derating");
+      Serial.println("prof: loop stages execution time (us)");
+      Serial.println("profr: reset the loop stages execution time");
+      Serial.println("idle: charge idle state and wake ups per second");
+      Serial.println("alerts: active alerts, by importance");
+      Serial.println("trace: dump the event trace");
+      Serial.println("tracer: clear the event trace");
       Serial.println("-----------------");
       break;
 
@@ -51,6 +66,35 @@ void handleCommand(const String& command) {
       Serial.println("%");
       break;
 
+    case hash("soc"): {
+      const battery::Snapshot snapshot = battery::get_snapshot();
+      Serial.print("state of charge:");
+      Serial.print(battery::get_state_of_charge());
+      Serial.println("%");
+      Serial.print("open circuit estimation:");
+      Serial.print(soc::get_open_circuit_soc(snapshot.openCircuitVoltage));
+      Serial.println("%");
+      Serial.print("battery voltage (filtered):");
+      Serial.print(snapshot.filteredVoltage);
+      Serial.println("V");
+      Serial.print("open circuit voltage:");
+      Serial.print(snapshot.openCircuitVoltage);
+      Serial.println("V");
+      Serial.print("internal resistance:");
+      Serial.print(battery::get_internal_resistance() * 1000.0);
+      Serial.println("mOhm");
+      break;
+    }
+
+    case hash("soclog"): {
+      static bool isLogging = false;
+      isLogging = not isLogging;
+      battery::set_state_of_charge_logging(isLogging);
+      Serial.print("state of charge logging:");
+      Serial.println(boolToString(isLogging));
+      break;
+    }
+
     case hash("vbus"):
       Serial.print("voltage on vbus:");
       Serial.print(charger::getVbusVoltage_mV());
@@ -67,6 +111,92 @@ void handleCommand(const String& command) {
       Serial.println(charger::charge_status());
       break;
 
+    case hash("temp"):
+      Serial.print("temperature (filtered):");
+      Serial.print(thermal::get_temperature());
+      Serial.println("C");
+      Serial.print("cpu temperature:");
+      Serial.print(thermal::get_cpu_temperature());
+      Serial.println("C");
+      Serial.print("imu temperature:");
+      Serial.print(thermal::get_imu_temperature());
+      Serial.println("C");
+      Serial.print("target temperature:");
+      Serial.print(thermal::get_target_temperature());
+      Serial.println("C");
+      Serial.print("allowed output:");
+      Serial.print(thermal::get_output_ratio() * 100.0);
+      Serial.println("%");
+      break;
+
+    case hash("prof"):
+      Serial.println("stage: count min avg max p99");
+      for (uint8_t i = 0; i < static_cast<uint8_t>(profiler::Stage::COUNT);
+           ++i) {
+        const profiler::Stage stage = static_cast<profiler::Stage>(i);
+        const profiler::Statistics stats = profiler::get_statistics(stage);
+        Serial.print(profiler::get_name(stage));
+        Serial.print(": ");
+        Serial.print(stats.count);
+        Serial.print(" ");
+        Serial.print(stats.min_us);
+        Serial.print(" ");
+        Serial.print(stats.average_us);
+        Serial.print(" ");
+        Serial.print(stats.max_us);
+        Serial.print(" ");
+        Serial.println(stats.p99_us);
+      }
+      break;
+
+    case hash("profr"):
+      profiler::reset();
+      Serial.println("loop stages execution time reset");
+      break;
+
+    case hash("idle"): {
+      using charge_idle::State;
+      Serial.print("charge idle:");
+      Serial.println(boolToString(charge_idle::is_idle()));
+      const float activeRate =
+          charge_idle::get_wakeups_per_second(State::ACTIVE);
+      const float idleRate = charge_idle::get_wakeups_per_second(State::IDLE);
+      Serial.print("wake ups per second (active):");
+      Serial.println(activeRate);
+      Serial.print("wake ups per second (idle):");
+      Serial.println(idleRate);
+      if (activeRate > 0.0 and idleRate > 0.0) {
+        Serial.print("reduction:");
+        Serial.print(activeRate / idleRate);
+        Serial.println("x");
+      }
+      break;
+    }
+
+    case hash("alerts"): {
+      const uint32_t current = AlertManager.current();
+      if (current == Alerts::NONE) {
+        Serial.println("no active alert");
+      }
+      for (uint8_t i = 0; i < alertCount; ++i) {
+        if ((current & (1ul << i)) == 0x0) continue;
+        Serial.print(get_alert_descriptor(i).name);
+        Serial.print(": active since ");
+        Serial.print(AlertManager.get_active_time(i));
+        Serial.println("ms");
+      }
+      break;
+    }
+
+    case hash("trace"):
+      tracer::dump(Serial);
+      break;
+
+    case hash("tracer"):
+      tracer::clear();
+      Serial.println("event trace cleared");
+      break;
+
     default:
       Serial.print("unknown command: ");
       Serial.println(command);
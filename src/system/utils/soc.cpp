@@ -0,0 +1,82 @@
+#include "soc.h"
+
+#include <cmath>
+
+namespace soc {
+
+// open circuit voltage of a li-ion cell (mV), by steps of 5%, from 0% to 100%
+static constexpr uint8_t socStep = 5;
+static constexpr uint16_t cellOpenCircuitVoltage_mV[] = {
+    3270, 3610, 3690, 3710, 3730, 3750, 3770, 3790, 3800, 3820, 3840,
+    3850, 3870, 3910, 3950, 3980, 4020, 4080, 4110, 4150, 4200};
+static constexpr uint8_t tableSize =
+    sizeof(cellOpenCircuitVoltage_mV) / sizeof(cellOpenCircuitVoltage_mV[0]);
+static_assert((tableSize - 1) * socStep == 100, "table must cover 0 to 100%");
+
+float get_open_circuit_soc(const float voltage_V) {
+  const float cellVoltage_mV = voltage_V * 1000.0 / cellCount;
+  if (cellVoltage_mV <= cellOpenCircuitVoltage_mV[0]) return 0.0;
+  if (cellVoltage_mV >= cellOpenCircuitVoltage_mV[tableSize - 1]) return 100.0;
+
+  // binary search of the segment: table[low] < voltage <= table[high]
+  uint8_t low = 0;
+  uint8_t high = tableSize - 1;
+  while (high - low > 1) {
+    const uint8_t middle = (low + high) / 2;
+    if (cellOpenCircuitVoltage_mV[middle] < cellVoltage_mV) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  // linear interpolation in the segment
+  const float lowVoltage_mV = cellOpenCircuitVoltage_mV[low];
+  const float ratio = (cellVoltage_mV - lowVoltage_mV) /
+                      (cellOpenCircuitVoltage_mV[high] - lowVoltage_mV);
+  return (low + ratio) * socStep;
+}
+
+void Estimator::restore(const float soc, const float voltage_V) {
+  const float openCircuitSoc = get_open_circuit_soc(voltage_V);
+  // the battery was changed or charged out of the lamp: the voltage wins
+  if (std::isnan(soc) or fabsf(soc - openCircuitSoc) > maxRestoreError) {
+    _soc = openCircuitSoc;
+  } else {
+    _soc = fminf(fmaxf(soc, 0.0), 100.0);
+  }
+  _isInitialized = true;
+}
+
+void Estimator::update(const uint32_t time_ms, const float current_mA,
+                       const float voltage_V) {
+  // the voltage relaxes for some time after a load change
+  const bool isLowCurrent = fabsf(current_mA) < restCurrent_mA;
+  if (isLowCurrent and not _isLowCurrent) {
+    _restStart_ms = time_ms;
+  }
+  _isLowCurrent = isLowCurrent;
+  _isResting = isLowCurrent and time_ms - _restStart_ms >= restDelay_ms;
+
+  if (not _isInitialized) {
+    // no persisted state: start from the voltage
+    _soc = get_open_circuit_soc(voltage_V);
+    _isInitialized = true;
+  } else if (_hasLastTime) {
+    const float elapsed_s = (time_ms - _lastTime_ms) / 1000.0;
+
+    // coulomb counting: mA.s to % of the capacity
+    _soc += current_mA * elapsed_s / (36.0 * _capacity_mAh);
+
+    // resting pack: its voltage is the open circuit voltage
+    if (_isResting) {
+      const float gain = 1.0 - expf(-elapsed_s / correctionTimeConstant_s);
+      _soc += gain * (get_open_circuit_soc(voltage_V) - _soc);
+    }
+    _soc = fminf(fmaxf(_soc, 0.0), 100.0);
+  }
+  _lastTime_ms = time_ms;
+  _hasLastTime = true;
+}
+
+}  // namespace soc
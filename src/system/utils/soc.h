@@ -0,0 +1,87 @@
+#ifndef SOC_H
+#define SOC_H
+
+#include <cstdint>
+
+/// Battery state of charge estimation: the charge and discharge currents are
+/// integrated (coulomb counting), and the result is pulled toward the open
+/// circuit voltage estimation when the battery rests.
+/// The currents come from the charger ADC (BQ25703A): the discharge current
+/// has a 256mA resolution, truncated. Under a steady load, up to 255mA are not
+/// counted (a 500mA load reads 256mA), so the estimation runs high until the
+/// pack rests. The battery alerts keep a voltage floor for this reason.
+/// No hardware access, so the estimator can be replayed on a host (see
+/// tools/soc_replay.cpp).
+namespace soc {
+
+// cells in series in the battery pack
+constexpr uint8_t cellCount = 4;
+// open circuit voltage of a cell under which the pack is empty, whatever the
+// state of charge estimation says (0% of the open circuit table is 3.27V)
+constexpr float cellCutoffVoltage_V = 3.3;
+
+/**
+ * \brief State of charge of the 4 li-ion cells pack, from its open circuit
+ * voltage (flash table, binary search and linear interpolation)
+ * \param[in] voltage_V the pack voltage, without load (or corrected by it)
+ * \return the state of charge, from 0 to 100 (%)
+ */
+float get_open_circuit_soc(const float voltage_V);
+
+class Estimator {
+ public:
+  // battery current under which the pack is considered resting (mA)
+  static constexpr float restCurrent_mA = 100.0;
+  // rest time before the pack voltage is trusted (relaxation)
+  static constexpr uint32_t restDelay_ms = 60000;
+  // time constant of the pull toward the open circuit estimation
+  static constexpr float correctionTimeConstant_s = 300.0;
+  // a restored state this far from the open circuit estimation is discarded
+  static constexpr float maxRestoreError = 15.0;  // %
+
+  /**
+   * \param[in] capacity_mAh nominal capacity of the pack
+   */
+  Estimator(const float capacity_mAh) : _capacity_mAh(capacity_mAh) {}
+
+  /**
+   * \brief Restore a persisted state of charge, after a shutdown (the pack
+   * rested while the lamp was off)
+   * \param[in] soc the persisted state of charge (%)
+   * \param[in] voltage_V pack voltage at startup, without load
+   */
+  void restore(const float soc, const float voltage_V);
+
+  /**
+   * \brief Integrate a new measure
+   * \param[in] time_ms time of the measure
+   * \param[in] current_mA battery current, positive when charging
+   * \param[in] voltage_V filtered pack voltage, corrected by the load
+   */
+  void update(const uint32_t time_ms, const float current_mA,
+              const float voltage_V);
+
+  bool is_initialized() const { return _isInitialized; }
+
+  // estimated state of charge, from 0 to 100 (%)
+  float get_soc() const { return _soc; }
+
+  // is the pack voltage trusted (resting long enough)
+  bool is_resting() const { return _isResting; }
+
+ private:
+  float _capacity_mAh;
+  float _soc = 0.0;
+  bool _isInitialized = false;
+
+  uint32_t _lastTime_ms = 0;
+  bool _hasLastTime = false;
+
+  uint32_t _restStart_ms = 0;
+  bool _isLowCurrent = false;
+  bool _isResting = false;
+};
+
+}  // namespace soc
+
+#endif
@@ -0,0 +1,68 @@
+#include "tracer.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+
+namespace tracer {
+
+static_assert((recordCount & (recordCount - 1)) == 0,
+              "recordCount must be a power of two");
+
+static Record records[recordCount];
+// total number of records written, the next one goes to index % recordCount
+static std::atomic<uint32_t> writeIndex(0);
+// records are not written during a dump
+static std::atomic<bool> isPaused(false);
+
+void trace(const Event event, const uint32_t argument) {
+  if (isPaused.load(std::memory_order_relaxed)) return;
+
+  // read the time first: the slot order then only differs from the time
+  // order when a writer is preempted between the two (the decoder sorts)
+  const uint32_t time = micros();
+  // reserve a slot, safe with concurrent writers
+  const uint32_t index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+  Record& record = records[index & (recordCount - 1)];
+  record.time = time;
+  record.argument = argument;
+  record.event = static_cast<uint16_t>(event);
+}
+
+// print a value as fixed width hex
+static void print_hex(Print& output, const uint32_t value,
+                      const uint8_t digits) {
+  for (int8_t shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+    output.print((value >> shift) & 0xF, HEX);
+  }
+}
+
+void dump(Print& output) {
+  isPaused.store(true);
+
+  const uint32_t written = writeIndex.load();
+  const uint32_t count = (written < recordCount) ? written : recordCount;
+
+  output.print("trace begin ");
+  output.print(count);
+  output.print(" ");
+  // lost records
+  output.println(written - count);
+
+  for (uint32_t i = written - count; i != written; ++i) {
+    const Record& record = records[i & (recordCount - 1)];
+    print_hex(output, record.time, 8);
+    output.print(" ");
+    print_hex(output, record.event, 4);
+    output.print(" ");
+    print_hex(output, record.argument, 8);
+    output.println();
+  }
+  output.println("trace end");
+
+  isPaused.store(false);
+}
+
+void clear() { writeIndex.store(0); }
+
+}  // namespace tracer
@@ -0,0 +1,53 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <cstdint>
+
+class Print;
+
+/// Low overhead event tracer: compact binary records (time, event, argument)
+/// in a RAM ring buffer, the oldest records are overwritten. Dumped over serial
+/// as hex lines, tools/trace_to_chrome.py converts a dump to a Chrome trace.
+namespace tracer {
+
+// keep the values in sync with tools/trace_to_chrome.py
+enum class Event : uint16_t {
+  PD_IC_EVENT = 1,         // FUSB302 events mask
+  PD_PROTOCOL_EVENT,       // PD protocol events mask
+  PD_POWER_READY,          // status << 24 | voltage << 12 | current
+  CHARGER_REGISTER_WRITE,  // register << 16 | value1 << 8 | value0
+  ALERT_RAISED,            // alert mask
+  ALERT_CLEARED,           // alert mask
+  FILE_WRITE_BEGIN,        // number of values written
+  FILE_WRITE_END,
+  FFT_BEGIN,               // number of samples
+  FFT_END,
+  LOOP_OVERRUN,            // loop runtime (ms)
+};
+
+struct Record {
+  uint32_t time;  // micros
+  uint32_t argument;
+  uint16_t event;
+};
+
+constexpr uint16_t recordCount = 256;  // a power of two
+
+/**
+ * \brief Add a record, from any thread or interrupt
+ */
+void trace(const Event event, const uint32_t argument = 0);
+
+/**
+ * \brief Write the records, oldest first, as hex lines "time event argument"
+ * between a "trace begin" and a "trace end" line. Tracing is paused meanwhile.
+ * A writer preempted while tracing can leave its record after a later one
+ */
+void dump(Print& output);
+
+// drop all the records
+void clear();
+
+}  // namespace tracer
+
+#endif
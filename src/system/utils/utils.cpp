@@ -7,7 +7,6 @@
 
 #include "../ext/math8.h"
 #include "../ext/scale8.h"
-#include "colorspace.h"
 
 namespace utils {
 
@@ -61,30 +60,55 @@ uint32_t get_random_color() {
   return colorArray.color;
 }
 
+uint16_t get_hue16(const COLOR color) {
+  const int32_t r = color.red;
+  const int32_t g = color.green;
+  const int32_t b = color.blue;
+
+  const int32_t max = MAX(r, MAX(g, b));
+  const int32_t delta = max - MIN(r, MIN(g, b));
+  if (delta == 0) return 0;
+
+  // sector of the maximum channel (in sixth of turn), and offset in it
+  int32_t sector;
+  int32_t offset;
+  if (max == r) {
+    sector = 0;
+    offset = g - b;
+  } else if (max == g) {
+    sector = 2;
+    offset = b - r;
+  } else {
+    sector = 4;
+    offset = r - g;
+  }
+  // negative hues wrap around in the 16 bits cast
+  return static_cast<uint16_t>(
+      (sector * 65536 + (offset * 65536) / delta) / 6);
+}
+
 uint32_t get_complementary_color(const uint32_t color) {
   COLOR c;
   c.color = color;
-  const uint16_t hue = ColorSpace::HSV(c).get_scaled_hue();
-
-  const uint16_t finalHue = (uint32_t)(hue + UINT16_MAX / 2.0) % UINT16_MAX;
   // add a cardan shift to the hue, to opbtain the symetrical color
-  return utils::hue_to_rgb_sinus(map(finalHue, 0, UINT16_MAX, 0, 360));
+  const uint16_t finalHue = get_hue16(c) + 32768;
+  return utils::hsv16_to_rgb(finalHue);
 }
 
 uint32_t get_random_complementary_color(const uint32_t color,
                                         const float tolerance) {
   COLOR c;
   c.color = color;
-  const float hue = ColorSpace::HSV(c).h;
+  const uint16_t hue = get_hue16(c);
 
-  // add random offset
-  const float comp =
-      360.0 * (0.1 + utils::map(rand(), 0, RAND_MAX, -tolerance / 2.0,
-                                tolerance / 2.0));
+  // add random offset (in 1/65536 of a turn)
+  const int32_t comp =
+      65536.0 * (0.1 + utils::map(rand(), 0, RAND_MAX, -tolerance / 2.0,
+                                  tolerance / 2.0));
 
-  const uint16_t finalHue =
-      fmod(hue + 360.0 / 2.0 + comp, 360.0f);  // add offset to the hue
-  return utils::hue_to_rgb_sinus(finalHue);
+  // add offset to the hue, the 16 bits overflow wraps it around
+  const uint16_t finalHue = hue + 32768 + comp;
+  return utils::hsv16_to_rgb(finalHue);
 }
 
 COLOR color_blend(COLOR color1, COLOR color2, uint16_t blend, bool b16) {
@@ -171,6 +195,146 @@ COLOR color_add(COLOR c1, COLOR c2, bool fast) {
   }
 }
 
+COLOR16 to_color16(const COLOR color) {
+  // x * 257 maps 255 to 65535 exactly
+  COLOR16 res;
+  res.white = color.white * 257;
+  res.red = color.red * 257;
+  res.green = color.green * 257;
+  res.blue = color.blue * 257;
+  return res;
+}
+
+COLOR to_color8(const COLOR16& color) {
+  COLOR res;
+  res.white = to_channel8(color.white);
+  res.red = to_channel8(color.red);
+  res.green = to_channel8(color.green);
+  res.blue = to_channel8(color.blue);
+  return res;
+}
+
+// interpolate a 16 bits channel, blend is the fraction of b (0 - 65535)
+static inline uint16_t lerp16(const uint16_t a, const uint16_t b,
+                              const uint16_t blend) {
+  if (b >= a) return a + scale16(b - a, blend);
+  return a - scale16(a - b, blend);
+}
+
+COLOR16 color_blend(const COLOR16& color1, const COLOR16& color2,
+                    uint16_t blend) {
+  COLOR16 res;
+  res.white = lerp16(color1.white, color2.white, blend);
+  res.red = lerp16(color1.red, color2.red, blend);
+  res.green = lerp16(color1.green, color2.green, blend);
+  res.blue = lerp16(color1.blue, color2.blue, blend);
+  return res;
+}
+
+// scale a 16 bits channel, the "video" version never reaches 0
+static inline uint16_t scale16_video(const uint16_t i, const uint16_t scale) {
+  return scale16(i, scale) + ((i and scale) ? 1 : 0);
+}
+
+/*
+ * fades color toward black, with 16 bits of precision
+ * if using "video" method the resulting color will never become black unless it
+ * is already black
+ */
+COLOR16 color_fade(COLOR16 c1, uint16_t amount, bool video) {
+  if (video) {
+    c1.red = scale16_video(c1.red, amount);
+    c1.green = scale16_video(c1.green, amount);
+    c1.blue = scale16_video(c1.blue, amount);
+    c1.white = scale16_video(c1.white, amount);
+  } else {
+    c1.red = scale16(c1.red, amount);
+    c1.green = scale16(c1.green, amount);
+    c1.blue = scale16(c1.blue, amount);
+    c1.white = scale16(c1.white, amount);
+  }
+  return c1;
+}
+
+COLOR16 color_add(COLOR16 c1, const COLOR16& c2, bool fast) {
+  if (fast) {
+    c1.red = qadd16(c1.red, c2.red);
+    c1.green = qadd16(c1.green, c2.green);
+    c1.blue = qadd16(c1.blue, c2.blue);
+    c1.white = qadd16(c1.white, c2.white);
+    return c1;
+  }
+
+  const uint32_t r = c1.red + c2.red;
+  const uint32_t g = c1.green + c2.green;
+  const uint32_t b = c1.blue + c2.blue;
+  const uint32_t w = c1.white + c2.white;
+  uint32_t max = r;
+  if (g > max) max = g;
+  if (b > max) max = b;
+  if (w > max) max = w;
+  if (max < 65536) {
+    c1.red = r;
+    c1.green = g;
+    c1.blue = b;
+    c1.white = w;
+  } else {
+    // keep the hue, scale the sum down to fit
+    c1.red = (uint64_t(r) * 65535) / max;
+    c1.green = (uint64_t(g) * 65535) / max;
+    c1.blue = (uint64_t(b) * 65535) / max;
+    c1.white = (uint64_t(w) * 65535) / max;
+  }
+  return c1;
+}
+
+// light intensity of a channel along the hue turn (64 steps of 1/64 turn):
+// raised sinus on 2/3 of the turn, off for the last third
+static const uint8_t hueWave[64] = {
+    0,   1,   5,   12,  21,  33,  47,  62,  79,  97,  115, 134, 152,
+    170, 188, 203, 218, 230, 240, 248, 253, 255, 254, 251, 245, 237,
+    226, 213, 198, 182, 165, 146, 128, 109, 90,  73,  57,  42,  29,
+    18,  10,  4,   1,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0};
+
+// interpolated read of the hue wave, phase in 1/65536 of a turn
+static inline uint8_t hue_wave(const uint16_t phase) {
+  const uint8_t index = phase >> 10;
+  const uint8_t fraction = (phase >> 2) & 0xFF;
+  const uint8_t a = hueWave[index];
+  const uint8_t b = hueWave[(index + 1) & 63];
+  if (b >= a) return a + scale8(b - a, fraction);
+  return a - scale8(a - b, fraction);
+}
+
+// apply the saturation then the value to a rainbow channel
+static inline uint8_t saturate_channel(const uint8_t channel,
+                                       const uint8_t saturation,
+                                       const uint8_t value) {
+  return scale8(scale8(channel, saturation) + (255 - saturation), value);
+}
+
+uint32_t hsv16_to_rgb(const uint16_t hue, const uint8_t saturation,
+                      const uint8_t value) {
+  // the channels are a third of turn apart, and wrap around with the phase
+  const uint8_t red = hue_wave(hue + 21845);
+  const uint8_t green = hue_wave(hue);
+  const uint8_t blue = hue_wave(hue + 43691);
+
+  union COLOR colorArray;
+  colorArray.white = 0;
+  if (saturation == 255 and value == 255) {
+    colorArray.red = red;
+    colorArray.green = green;
+    colorArray.blue = blue;
+  } else {
+    colorArray.red = saturate_channel(red, saturation, value);
+    colorArray.green = saturate_channel(green, saturation, value);
+    colorArray.blue = saturate_channel(blue, saturation, value);
+  }
+  return colorArray.color;
+}
+
 uint32_t hue_to_rgb_sinus(const uint16_t angle) {
   static const uint8_t lights[360] = {
       0,   0,   0,   0,   0,   1,   1,   2,   2,   3,   4,   5,   6,   7,   8,
@@ -199,6 +363,7 @@ uint32_t hue_to_rgb_sinus(const uint16_t angle) {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0};
 
   union COLOR colorArray;
+  colorArray.white = 0;
   colorArray.red = lights[(angle + 120) % 360];
   colorArray.green = lights[angle % 360];
   colorArray.blue = lights[(angle + 240) % 360];
@@ -209,45 +374,61 @@ float map(float x, float in_min, float in_max, float out_min, float out_max) {
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
-// gamma 2.8 lookup table used for color correction
-static uint8_t gammaT[256] = {
-    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,
-    2,   2,   2,   2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,
-    4,   5,   5,   5,   5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,
-    8,   9,   9,   9,   10,  10,  10,  11,  11,  11,  12,  12,  13,  13,  13,
-    14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,  20,  20,  21,
-    21,  22,  22,  23,  24,  24,  25,  25,  26,  27,  27,  28,  29,  29,  30,
-    31,  32,  32,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,  42,
-    43,  44,  45,  46,  47,  48,  49,  50,  50,  51,  52,  54,  55,  56,  57,
-    58,  59,  60,  61,  62,  63,  64,  66,  67,  68,  69,  70,  72,  73,  74,
-    75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,  90,  92,  93,  95,
-    96,  98,  99,  101, 102, 104, 105, 107, 109, 110, 112, 114, 115, 117, 119,
-    120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142, 144, 146,
-    148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175, 177,
-    180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
-    215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252,
-    255};
-
-// re-calculates & fills gamma table
+constexpr Curve8 Cie1931Curve::table;
+
+// curve used by gamma8 and gamma32
+static const Curve8* gammaCurve = &DefaultGammaCurve::table;
+
+void set_gamma_curve(const Curve8& curve) { gammaCurve = &curve; }
+
+#ifdef USE_RUNTIME_GAMMA_TABLE
+static Curve8 runtimeGammaCurve;
+
+// re-calculates, fills & selects the runtime gamma table
 void calcGammaTable(float gamma) {
   for (size_t i = 0; i < 256; i++) {
-    gammaT[i] = (int)(powf((float)i / 255.0f, gamma) * 255.0f + 0.5f);
+    runtimeGammaCurve.values[i] =
+        (int)(powf((float)i / 255.0f, gamma) * 255.0f + 0.5f);
   }
+  set_gamma_curve(runtimeGammaCurve);
 }
+#endif
 
-uint8_t gamma8(uint8_t value) { return gammaT[value]; }
+uint8_t gamma8(uint8_t value) { return (*gammaCurve)[value]; }
 
 // used for color gamma correction
-COLOR gamma32(COLOR color) {
-  color.white = gammaT[color.white];
-  color.red = gammaT[color.red];
-  color.green = gammaT[color.green];
-  color.blue = gammaT[color.blue];
+COLOR gamma32(COLOR color) { return gamma32(color, *gammaCurve); }
+
+uint8_t gamma8(uint8_t value, const Curve8& curve) { return curve[value]; }
+
+COLOR gamma32(COLOR color, const Curve8& curve) {
+  color.white = curve[color.white];
+  color.red = curve[color.red];
+  color.green = curve[color.green];
+  color.blue = curve[color.blue];
   return color;
 }
 
+// curve used by gamma16 and gamma64
+static const Curve16* gammaCurve16 = &DefaultGammaCurve16::table;
+
+void set_gamma_curve(const Curve16& curve) { gammaCurve16 = &curve; }
+
+uint16_t gamma16(uint16_t value) { return (*gammaCurve16)(value); }
+
+COLOR16 gamma64(const COLOR16& color) { return gamma64(color, *gammaCurve16); }
+
+uint16_t gamma16(uint16_t value, const Curve16& curve) { return curve(value); }
+
+COLOR16 gamma64(const COLOR16& color, const Curve16& curve) {
+  COLOR16 res;
+  res.white = curve(color.white);
+  res.red = curve(color.red);
+  res.green = curve(color.green);
+  res.blue = curve(color.blue);
+  return res;
+}
+
 double analogToDividerVoltage(const uint16_t analogVal) {
   static constexpr float multiplier =
       (1.0 / (float)ADC_MAX_VALUE) * maxConvertedVoltage;
@@ -4,6 +4,7 @@
 #include <cstdint>
 
 #include "constants.h"
+#include "curves.h"
 
 #define SQR(x) ((x) * (x))
 #define POW2(x) SQR(x)
@@ -28,6 +29,17 @@ union COLOR {
   };
 };
 
+/**
+ * \brief 16 bits per channel color, to compute fades and dimming without
+ * banding. An 8 bits color converts to COLOR16 and back without loss.
+ */
+struct COLOR16 {
+  uint16_t blue;
+  uint16_t green;
+  uint16_t red;
+  uint16_t white;
+};
+
 namespace utils {
 
 /**
@@ -65,14 +77,85 @@ COLOR color_blend(COLOR color1, COLOR color2, uint16_t blend, bool b16 = false);
 COLOR color_fade(COLOR c1, uint8_t amount, bool video = false);
 COLOR color_add(COLOR c1, COLOR c2, bool fast = false);
 
+/**
+ * \brief Expand an 8 bits color to 16 bits per channel (255 -> 65535)
+ */
+COLOR16 to_color16(const COLOR color);
+
+/**
+ * \brief Round a 16 bits per channel color to the nearest 8 bits color
+ */
+COLOR to_color8(const COLOR16& color);
+
+// round a 16 bits channel to the nearest 8 bits channel
+inline uint8_t to_channel8(const uint16_t channel) {
+  return (channel - (channel >> 8) + 0x80) >> 8;
+}
+
+// 16 bits per channel versions of the color operations
+COLOR16 color_blend(const COLOR16& color1, const COLOR16& color2,
+                    uint16_t blend);
+COLOR16 color_fade(COLOR16 c1, uint16_t amount, bool video = false);
+COLOR16 color_add(COLOR16 c1, const COLOR16& c2, bool fast = false);
+
+/**
+ * \brief Integer hue of a color
+ * \param[in] color The color to extract the hue of
+ * \return the hue, in 1/65536 of a turn (0 is red, 21845 is green)
+ */
+uint16_t get_hue16(const COLOR color);
+
+/**
+ * \brief Convert a 16 bits phase hue to a sinus rainbow color
+ * \param[in] hue in 1/65536 of a turn (0 is red, 21845 is green)
+ * \param[in] saturation 0 (white) to 255 (full color)
+ * \param[in] value 0 (black) to 255 (full brightness)
+ */
+uint32_t hsv16_to_rgb(const uint16_t hue, const uint8_t saturation = 255,
+                      const uint8_t value = 255);
+
+// hue in degrees
 uint32_t hue_to_rgb_sinus(const uint16_t angle);
 
 float map(float x, float in_min, float in_max, float out_min, float out_max);
 
-void calcGammaTable(float gamma);
+// default gamma correction curve
+using DefaultGammaCurve = GammaCurve<280>;
+
+/**
+ * \brief Select the curve used by gamma8 and gamma32
+ * \param[in] curve a flash stored curve, like GammaCurve<220>::table or
+ * Cie1931Curve::table
+ */
+void set_gamma_curve(const Curve8& curve);
+
 COLOR gamma32(COLOR color);
 uint8_t gamma8(uint8_t value);
 
+// gamma correction with a specific curve
+COLOR gamma32(COLOR color, const Curve8& curve);
+uint8_t gamma8(uint8_t value, const Curve8& curve);
+
+// 16 bits per channel gamma correction
+using DefaultGammaCurve16 = GammaCurve16<280>;
+
+/**
+ * \brief Select the curve used by gamma16 and gamma64
+ * \param[in] curve a flash stored curve, like GammaCurve16<220>::table
+ */
+void set_gamma_curve(const Curve16& curve);
+
+COLOR16 gamma64(const COLOR16& color);
+uint16_t gamma16(uint16_t value);
+
+COLOR16 gamma64(const COLOR16& color, const Curve16& curve);
+uint16_t gamma16(uint16_t value, const Curve16& curve);
+
+#ifdef USE_RUNTIME_GAMMA_TABLE
+// re-calculates & selects a gamma table in RAM (slow, prefer GammaCurve)
+void calcGammaTable(float gamma);
+#endif
+
 // Convert a read on an analog pin to a voltage value
 // Depends on the set maxConvertedVoltage !!!!
 double analogToDividerVoltage(const uint16_t analogVal);
@@ -0,0 +1,169 @@
+// Stress the alert masks with concurrent raise and clear requests:
+//     g++ -std=gnu++17 -O2 -pthread -I host -include host/Arduino.h
+//         -o alerts_stress alerts_stress.cpp ../src/system/alerts.cpp
+//     ./alerts_stress
+// (the g++ command is on one line, add -fsanitize=thread to also check the
+// memory orders)
+// Four threads raise and clear alerts on one Alert object:
+// - own alerts: each thread toggles its own two alerts, and leaves one raised.
+//   The requested mask, the active mask after update and the change count
+//   must be exact
+// - with updater: the same, while another thread runs update (the power
+//   thread) and reads the active alerts
+// - shared alert: all the threads toggle the same alert, with the updater
+// The tracer is replaced by counters: each alert must have as many raise as
+// clear transitions, plus one if it ends raised. A lost fetch or/fetch and
+// breaks the final masks, a duplicated transition breaks the counts, and the
+// change count must never go back.
+// Returns 1 if an update is lost or duplicated.
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "../src/system/alerts.h"
+
+static constexpr uint8_t threadCount = 4;
+static constexpr uint32_t iterations = 200000;
+// past every raise and clear delay
+static constexpr uint32_t settleTime_ms = 10000;
+
+// transitions traced by the alerts, by alert bit
+static std::atomic<uint32_t> raisedCount[alertCount];
+static std::atomic<uint32_t> clearedCount[alertCount];
+
+namespace tracer {
+
+void trace(const Event event, const uint32_t argument) {
+  const uint8_t index = __builtin_ctz(argument);
+  if (event == Event::ALERT_RAISED) raisedCount[index]++;
+  if (event == Event::ALERT_CLEARED) clearedCount[index]++;
+}
+
+}  // namespace tracer
+
+static void reset_counts() {
+  for (uint8_t i = 0; i < alertCount; ++i) {
+    raisedCount[i] = 0;
+    clearedCount[i] = 0;
+  }
+}
+
+// each alert has alternating transitions, and ends in the expected state
+static bool is_count_valid(const uint32_t requested) {
+  for (uint8_t i = 0; i < alertCount; ++i) {
+    const uint32_t isRaised = (requested >> i) & 1;
+    if (raisedCount[i] != clearedCount[i] + isRaised) return false;
+  }
+  return true;
+}
+
+static uint32_t get_transition_count() {
+  uint32_t count = 0;
+  for (uint8_t i = 0; i < alertCount; ++i) {
+    count += raisedCount[i] + clearedCount[i];
+  }
+  return count;
+}
+
+// toggle two alerts, the second one stays raised when they differ
+static void toggle(Alert& alerts, const Alerts first, const Alerts second) {
+  for (uint32_t i = 0; i < iterations; ++i) {
+    alerts.raise_alert(first);
+    alerts.raise_alert(second);
+    alerts.clear_alert(first);
+    if (i != iterations - 1) alerts.clear_alert(second);
+    if ((i & 255) == 0) std::this_thread::yield();
+  }
+}
+
+static Alerts get_alert(const uint8_t index) {
+  return static_cast<Alerts>(1u << index);
+}
+
+struct Result {
+  uint32_t current;
+  uint32_t sequence;
+  uint32_t transitions;
+  bool isCountValid;
+  bool isSequenceMonotonic;  // as seen by the updater
+};
+
+// run the workers, with an updater thread if asked, then settle the delays
+template <typename Worker>
+static Result run(const Worker& worker, const bool withUpdater) {
+  Alert alerts;
+  reset_counts();
+  host::time_ms = 1000;
+
+  std::atomic<bool> isDone(false);
+  bool isSequenceMonotonic = true;
+  std::thread updater([&]() {
+    if (not withUpdater) return;
+    uint32_t lastSequence = 0;
+    while (not isDone.load()) {
+      alerts.update(host::time_ms);
+      const uint32_t sequence = alerts.get_change_sequence();
+      isSequenceMonotonic = isSequenceMonotonic and sequence >= lastSequence;
+      lastSequence = sequence;
+      std::this_thread::yield();
+    }
+  });
+
+  std::vector<std::thread> workers;
+  for (uint8_t t = 0; t < threadCount; ++t) {
+    workers.emplace_back([&alerts, &worker, t]() { worker(alerts, t); });
+  }
+  for (std::thread& thread : workers) thread.join();
+  isDone.store(true);
+  updater.join();
+
+  alerts.update(host::time_ms + settleTime_ms);
+  return {alerts.current(), alerts.get_change_sequence(),
+          get_transition_count(), is_count_valid(alerts.current()),
+          isSequenceMonotonic};
+}
+
+static bool check(const char* name, const Result& r,
+                  const uint32_t expectedCurrent) {
+  const bool isValid = r.current == expectedCurrent and r.isCountValid and
+                       r.isSequenceMonotonic;
+  printf("%-16s %8x %8x %12u %12u %s\n", name, r.current, expectedCurrent,
+         r.transitions, r.sequence, isValid ? "ok" : "FAILED");
+  return isValid;
+}
+
+int main() {
+  printf("%u threads, %u iterations\n", threadCount, iterations);
+  printf("%-16s %8s %8s %12s %12s\n", "run", "active", "expected",
+         "transitions", "changes");
+
+  const auto ownAlerts = [](Alert& alerts, const uint8_t thread) {
+    toggle(alerts, get_alert(2 * thread), get_alert(2 * thread + 1));
+  };
+  // the second alert of each thread stays raised
+  static constexpr uint32_t ownExpected = 0xAA;
+
+  // without an updater, every change is a raise or clear transition, plus
+  // the final update
+  const Result own = run(ownAlerts, false);
+  const uint32_t ownTransitions = threadCount * (4 * iterations - 1);
+  bool isValid = check("own alerts", own, ownExpected) and
+                 own.transitions == ownTransitions and
+                 own.sequence == ownTransitions + 1;
+
+  isValid = check("with updater", run(ownAlerts, true), ownExpected) and
+            isValid;
+
+  // the last request of every thread is a clear: the shared alert ends
+  // cleared
+  const Result shared = run(
+      [](Alert& alerts, const uint8_t) {
+        toggle(alerts, Alerts::TEMP_TOO_HIGH, Alerts::TEMP_TOO_HIGH);
+      },
+      true);
+  isValid = check("shared alert", shared, Alerts::NONE) and isValid;
+
+  return isValid ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Compare the batched planar OKLAB/OKLCH conversions to the per object path,
+// on spans of 64, 256 and 1024 colors:
+//     S=../src/system/utils
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o batch_bench batch_bench.cpp
+//         $S/colorspace.cpp $S/linearization.cpp $S/fixed_point.cpp
+//     ./batch_bench
+// (the g++ command is on one line)
+// Each span is converted to the space and back to RGB. The per object path
+// goes through a Base reference, like the callers that hold a color space.
+// Returns 1 if a batch output differs from the per object output.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../src/system/utils/colorspace.h"
+
+using namespace utils::ColorSpace;
+
+// colors converted by each measure, whatever the span size
+static constexpr int convertedColors = 2000000;
+
+typedef void (*ToPlanes)(const COLOR*, const size_t, real_t*, real_t*,
+                         real_t*);
+typedef void (*FromPlanes)(const real_t*, const real_t*, const real_t*,
+                           const size_t, COLOR*);
+
+template <typename Function> static double time_s(const Function& function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+template <typename Space>
+static int run(const char* name, const int count, ToPlanes to_planes,
+               FromPlanes from_planes) {
+  std::vector<COLOR> colors(count), batchOutput(count);
+  std::vector<real_t> x(count), y(count), z(count);
+  for (int i = 0; i < count; i++) {
+    // spread the colors with a multiplicative hash
+    colors[i].color = (i * 2654435761u) & 0xFFFFFF;
+  }
+
+  const int repeats = convertedColors / count;
+  uint32_t sink = 0;
+  const double object_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      for (int i = 0; i < count; i++) {
+        const Space space(colors[i]);
+        const Base& base = space;
+        sink += base.get_rgb().color;
+      }
+    }
+  });
+  const double batch_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      to_planes(colors.data(), count, x.data(), y.data(), z.data());
+      from_planes(x.data(), y.data(), z.data(), count, batchOutput.data());
+      sink += batchOutput[r % count].color;
+    }
+  });
+
+  int mismatches = 0;
+  for (int i = 0; i < count; i++) {
+    if (Space(colors[i]).get_rgb().color != batchOutput[i].color) mismatches++;
+  }
+
+  printf("%-6s %5d %12.1f %12.1f %7.0f%% %10d\n", name, count,
+         object_s * 1e9 / (repeats * count), batch_s * 1e9 / (repeats * count),
+         100.0 * (1.0 - batch_s / object_s), mismatches);
+
+  // keep the timed loops from being optimized out
+  if (sink == 1) printf(" ");
+  return mismatches;
+}
+
+int main() {
+  static const char* precisions[] = {"double", "float", "fixed"};
+  printf("precision: %s\n", precisions[COLORSPACE_PRECISION]);
+  printf("%-6s %5s %12s %12s %8s %10s\n", "space", "count", "object ns",
+         "batch ns", "saved", "mismatches");
+
+  int mismatches = 0;
+  for (const int count : {64, 256, 1024}) {
+    mismatches += run<OKLAB>("OKLAB", count, rgb_to_oklab, oklab_to_rgb);
+  }
+  for (const int count : {64, 256, 1024}) {
+    mismatches += run<OKLCH>("OKLCH", count, rgb_to_oklch, oklch_to_rgb);
+  }
+  return mismatches == 0 ? 0 : 1;
+}
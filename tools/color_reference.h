@@ -0,0 +1,133 @@
+#ifndef COLOR_REFERENCE_H
+#define COLOR_REFERENCE_H
+
+// Double precision reference of the colorspace conversions, written from the
+// formulas (pow transfer functions, no table), to measure the errors of the
+// lamp implementation in the host tools.
+
+#include <cmath>
+#include <cstdint>
+
+namespace reference {
+
+// sRGB channel (0 - 1) to linear light (0 - 1)
+inline double to_linear(const double c) {
+  return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+// linear light (0 - 1) to sRGB channel (0 - 1)
+inline double from_linear(const double c) {
+  return c <= 0.0031308 ? c * 12.92 : 1.055 * pow(c, 1.0 / 2.4) - 0.055;
+}
+
+// linear light to the nearest 8 bits channel, clamped
+inline uint8_t to_channel(const double linear) {
+  const double c = round(from_linear(linear) * 255.0);
+  return c <= 0.0 ? 0 : c >= 255.0 ? 255 : static_cast<uint8_t>(c);
+}
+
+struct Triplet {
+  double a, b, c;
+};
+
+inline Triplet rgb_to_linear(const uint8_t r, const uint8_t g,
+                             const uint8_t b) {
+  return {to_linear(r / 255.0), to_linear(g / 255.0), to_linear(b / 255.0)};
+}
+
+// linear light to CIE XYZ, D65, 0 - 100
+inline Triplet linear_to_xyz(const Triplet& l) {
+  return {(0.4124564 * l.a + 0.3575761 * l.b + 0.1804375 * l.c) * 100.0,
+          (0.2126729 * l.a + 0.7151522 * l.b + 0.0721750 * l.c) * 100.0,
+          (0.0193339 * l.a + 0.1191920 * l.b + 0.9503041 * l.c) * 100.0};
+}
+
+inline Triplet xyz_to_linear(const Triplet& xyz) {
+  const double x = xyz.a / 100.0;
+  const double y = xyz.b / 100.0;
+  const double z = xyz.c / 100.0;
+  return {3.2404542 * x - 1.5371385 * y - 0.4985314 * z,
+          -0.9692660 * x + 1.8760108 * y + 0.0415560 * z,
+          0.0556434 * x - 0.2040259 * y + 1.0572252 * z};
+}
+
+inline Triplet rgb_to_xyz(const uint8_t r, const uint8_t g, const uint8_t b) {
+  return linear_to_xyz(rgb_to_linear(r, g, b));
+}
+
+// CIE LAB, D65 white
+inline Triplet xyz_to_lab(const Triplet& xyz) {
+  auto f = [](const double t) {
+    return t > 0.008856 ? cbrt(t) : 7.787 * t + 16.0 / 116.0;
+  };
+  const double fx = f(xyz.a / 95.047);
+  const double fy = f(xyz.b / 100.000);
+  const double fz = f(xyz.c / 108.883);
+  return {116.0 * fy - 16.0, 500.0 * (fx - fy), 200.0 * (fy - fz)};
+}
+
+inline Triplet lab_to_xyz(const Triplet& lab) {
+  auto f = [](const double t) {
+    const double t3 = t * t * t;
+    return t3 > 0.008856 ? t3 : (t - 16.0 / 116.0) / 7.787;
+  };
+  const double fy = (lab.a + 16.0) / 116.0;
+  return {95.047 * f(fy + lab.b / 500.0), 100.000 * f(fy),
+          108.883 * f(fy - lab.c / 200.0)};
+}
+
+inline Triplet rgb_to_lab(const uint8_t r, const uint8_t g, const uint8_t b) {
+  return xyz_to_lab(rgb_to_xyz(r, g, b));
+}
+
+inline Triplet linear_to_oklab(const Triplet& l) {
+  const double lms[3] = {
+      cbrt(0.4122214708 * l.a + 0.5363325363 * l.b + 0.0514459929 * l.c),
+      cbrt(0.2119034982 * l.a + 0.6806995451 * l.b + 0.1073969566 * l.c),
+      cbrt(0.0883024619 * l.a + 0.2817188376 * l.b + 0.6299787005 * l.c)};
+  return {0.2104542553 * lms[0] + 0.7936177850 * lms[1] -
+              0.0040720468 * lms[2],
+          1.9779984951 * lms[0] - 2.4285922050 * lms[1] +
+              0.4505937099 * lms[2],
+          0.0259040371 * lms[0] + 0.7827717662 * lms[1] -
+              0.8086757660 * lms[2]};
+}
+
+inline Triplet rgb_to_oklab(const uint8_t r, const uint8_t g,
+                            const uint8_t b) {
+  return linear_to_oklab(rgb_to_linear(r, g, b));
+}
+
+// OKLAB to linear light
+inline Triplet oklab_to_linear(const Triplet& lab) {
+  double l = lab.a + 0.3963377774 * lab.b + 0.2158037573 * lab.c;
+  double m = lab.a - 0.1055613458 * lab.b - 0.0638541728 * lab.c;
+  double s = lab.a - 0.0894841775 * lab.b - 1.2914855480 * lab.c;
+  l = l * l * l;
+  m = m * m * m;
+  s = s * s * s;
+  return {4.0767245293 * l - 3.3072168827 * m + 0.2307590544 * s,
+          -1.2681437731 * l + 2.6093323231 * m - 0.3411344290 * s,
+          -0.0041119885 * l - 0.7034763098 * m + 1.7068625689 * s};
+}
+
+// polar form of a LAB like triplet (l, chroma, hue in degrees 0 - 360)
+inline Triplet to_polar(const Triplet& lab) {
+  double h = atan2(lab.c, lab.b) * 180.0 / M_PI;
+  if (h < 0.0) h += 360.0;
+  return {lab.a, hypot(lab.b, lab.c), h};
+}
+
+inline Triplet from_polar(const Triplet& lch) {
+  const double h = lch.c * M_PI / 180.0;
+  return {lch.a, lch.b * cos(h), lch.b * sin(h)};
+}
+
+// largest absolute difference between the components of two triplets
+inline double max_difference(const Triplet& x, const Triplet& y) {
+  return fmax(fabs(x.a - y.a), fmax(fabs(x.b - y.b), fabs(x.c - y.c)));
+}
+
+}  // namespace reference
+
+#endif
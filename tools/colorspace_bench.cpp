@@ -0,0 +1,182 @@
+// Precision and speed of the colorspace conversions, for one
+// COLORSPACE_PRECISION. Build it once per precision and compare the outputs:
+//     S=../src/system/utils
+//     for p in 0 1 2; do
+//       g++ -std=gnu++17 -O2 -DCOLORSPACE_PRECISION=$p -I host
+//           -include host/Arduino.h -o colorspace_bench_$p colorspace_bench.cpp
+//           $S/colorspace.cpp $S/linearization.cpp $S/fixed_point.cpp
+//       ./colorspace_bench_$p
+//     done
+// (the g++ command is on one line)
+// For each space, on a grid of 52^3 colors (all channels by steps of 5):
+// - round trip: largest channel error of RGB -> space -> RGB (LSB)
+// - forward: largest component error of RGB -> space, against the double
+//   precision formulas of color_reference.h (space units)
+// - conversions per second, counting both directions
+// Then the divisions by zero of real_t: the fixed point saturates to its max
+// (or min), float and double give infinities and NaN (reported only).
+// Returns 1 if a fixed point division by zero does not saturate.
+
+#include <chrono>
+#include <cstdio>
+
+#include "../src/system/utils/colorspace.h"
+#include "color_reference.h"
+
+using namespace utils::ColorSpace;
+
+static constexpr int gridStep = 5;
+
+struct Result {
+  int roundTripError = 0;
+  double forwardError = 0.0;
+  double conversionsPerSecond = 0.0;
+};
+
+static int channel_error(const COLOR& x, const COLOR& y) {
+  return max(max(abs(x.red - y.red), abs(x.green - y.green)),
+             abs(x.blue - y.blue));
+}
+
+template <typename T> static double component(const T& v) {
+  return static_cast<double>(v);
+}
+
+// Run the space over the grid. Forward returns the reference components of a
+// color, and the components of the space object
+template <typename Space, typename Forward>
+static Result run(const Forward& forward) {
+  Result result;
+  uint32_t sink = 0;
+  long count = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < 256; r += gridStep) {
+    for (int g = 0; g < 256; g += gridStep) {
+      for (int b = 0; b < 256; b += gridStep) {
+        COLOR c;
+        c.color = 0;
+        c.red = r;
+        c.green = g;
+        c.blue = b;
+        sink += Space(c).get_rgb().color;
+        count++;
+      }
+    }
+  }
+  const double elapsed_s = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+  result.conversionsPerSecond = 2.0 * count / elapsed_s;
+
+  for (int r = 0; r < 256; r += gridStep) {
+    for (int g = 0; g < 256; g += gridStep) {
+      for (int b = 0; b < 256; b += gridStep) {
+        COLOR c;
+        c.color = 0;
+        c.red = r;
+        c.green = g;
+        c.blue = b;
+        const Space space(c);
+        result.roundTripError =
+            max(result.roundTripError, channel_error(space.get_rgb(), c));
+
+        reference::Triplet expected, actual;
+        if (forward(c, space, expected, actual)) {
+          result.forwardError =
+              fmax(result.forwardError,
+                   reference::max_difference(expected, actual));
+        }
+      }
+    }
+  }
+
+  // keep the timed loop from being optimized out
+  if (sink == 1) printf(" ");
+  return result;
+}
+
+static void print(const char* name, const Result& result) {
+  if (result.forwardError >= 0.0) {
+    printf("%-6s %10d %12.6f %14.0f\n", name, result.roundTripError,
+           result.forwardError, result.conversionsPerSecond);
+  } else {
+    printf("%-6s %10d %12s %14.0f\n", name, result.roundTripError, "-",
+           result.conversionsPerSecond);
+  }
+}
+
+// division and remainder by zero, on a positive and a negative dividend
+static bool check_division_by_zero() {
+  using std::fmod;
+  const real_t zero = real_t(0.0);
+  const real_t five = real_t(5.0);
+  const double quotient = component(five / zero);
+  const double negativeQuotient = component(-five / zero);
+  const double remainder = component(fmod(five, zero));
+  const double negativeRemainder = component(fmod(-five, zero));
+  printf("division by zero: 5/0 %g, -5/0 %g, fmod(5, 0) %g, fmod(-5, 0) %g\n",
+         quotient, negativeQuotient, remainder, negativeRemainder);
+
+#if COLORSPACE_PRECISION == COLORSPACE_FIXED
+  const double max = component(real_t::from_raw(INT32_MAX));
+  const double min = component(real_t::from_raw(INT32_MIN));
+  return quotient == max and negativeQuotient == min and remainder == max and
+         negativeRemainder == min;
+#else
+  return true;
+#endif
+}
+
+int main() {
+  static const char* precisions[] = {"double", "float", "fixed"};
+  printf("precision: %s\n", precisions[COLORSPACE_PRECISION]);
+  printf("%-6s %10s %12s %14s\n", "space", "round trip", "forward", "conv/s");
+
+  print("XYZ", run<XYZ>([](const COLOR& c, const XYZ& s,
+                           reference::Triplet& expected,
+                           reference::Triplet& actual) {
+          expected = reference::rgb_to_xyz(c.red, c.green, c.blue);
+          actual = {component(s.x), component(s.y), component(s.z)};
+          return true;
+        }));
+  // no reference for the HSV components, only the round trip is measured
+  Result hsv = run<HSV>([](const COLOR&, const HSV&, reference::Triplet&,
+                           reference::Triplet&) { return false; });
+  hsv.forwardError = -1.0;
+  print("HSV", hsv);
+  print("LAB", run<LAB>([](const COLOR& c, const LAB& s,
+                           reference::Triplet& expected,
+                           reference::Triplet& actual) {
+          expected = reference::rgb_to_lab(c.red, c.green, c.blue);
+          actual = {component(s.l), component(s.a), component(s.b)};
+          return true;
+        }));
+  // the hue of the polar spaces is undefined for grays: compare the
+  // cartesian form
+  print("LCH", run<LCH>([](const COLOR& c, const LCH& s,
+                           reference::Triplet& expected,
+                           reference::Triplet& actual) {
+          expected = reference::rgb_to_lab(c.red, c.green, c.blue);
+          actual = reference::from_polar(
+              {component(s.l), component(s.c), component(s.h)});
+          return true;
+        }));
+  print("OKLAB", run<OKLAB>([](const COLOR& c, const OKLAB& s,
+                               reference::Triplet& expected,
+                               reference::Triplet& actual) {
+          expected = reference::rgb_to_oklab(c.red, c.green, c.blue);
+          actual = {component(s.l), component(s.a), component(s.b)};
+          return true;
+        }));
+  print("OKLCH", run<OKLCH>([](const COLOR& c, const OKLCH& s,
+                               reference::Triplet& expected,
+                               reference::Triplet& actual) {
+          expected = reference::rgb_to_oklab(c.red, c.green, c.blue);
+          actual = reference::from_polar(
+              {component(s.l), component(s.c), component(s.h)});
+          return true;
+        }));
+
+  return check_division_by_zero() ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// Compare the compile time conversion graph to the chain through 8 bits RGB:
+//     S=../src/system/utils
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o colorspace_graph_test colorspace_graph_test.cpp
+//         $S/colorspace.cpp $S/linearization.cpp $S/fixed_point.cpp
+//     ./colorspace_graph_test
+// (the g++ command is on one line, add -DCOLORSPACE_PRECISION=0 or 2 to test
+// the other precisions)
+// On a grid of LCH and OKLCH colors inside the sRGB gamut, converts
+// LCH -> OKLCH and OKLCH -> LCH:
+// - with convert<To>(from), through linear RGB
+// - with the chain To(from.get_rgb()), through a COLOR
+// and reports the largest error of both against the double precision formulas
+// of color_reference.h (cartesian components, the hue is undefined for
+// grays, OKLAB units for OKLCH and LAB units for LCH), and the time per
+// conversion.
+// Returns 1 if the graph is less accurate than the chain.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../src/system/utils/colorspace_graph.h"
+#include "color_reference.h"
+
+using namespace utils::ColorSpace;
+using reference::Triplet;
+
+static constexpr int repeats = 20;
+
+template <typename Function> static double time_s(const Function& function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+static bool is_in_gamut(const Triplet& linear) {
+  static constexpr double margin = 1e-3;
+  return linear.a >= margin and linear.a <= 1.0 - margin and
+         linear.b >= margin and linear.b <= 1.0 - margin and
+         linear.c >= margin and linear.c <= 1.0 - margin;
+}
+
+// polar components of a space object
+template <typename Space> static Triplet get_polar(const Space& c) {
+  return {static_cast<double>(c.l), static_cast<double>(c.c),
+          static_cast<double>(c.h)};
+}
+
+struct Result {
+  double graphError = 0.0;
+  double chainError = 0.0;
+  double graph_ns = 0.0;
+  double chain_ns = 0.0;
+};
+
+// convert every input From -> To, reference gives the expected cartesian
+// form of To for an input
+template <typename To, typename From, typename Reference>
+static Result run(const std::vector<Triplet>& inputs,
+                  const Reference& reference) {
+  Result result;
+  for (const Triplet& input : inputs) {
+    const From from(real_t(input.a), real_t(input.b), real_t(input.c));
+    const Triplet expected = reference(input);
+    const Triplet graph = reference::from_polar(get_polar(convert<To>(from)));
+    const Triplet chain = reference::from_polar(get_polar(To(from.get_rgb())));
+    result.graphError =
+        fmax(result.graphError, reference::max_difference(graph, expected));
+    result.chainError =
+        fmax(result.chainError, reference::max_difference(chain, expected));
+  }
+
+  double sink = 0.0;
+  const double graph_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      for (const Triplet& input : inputs) {
+        const From from(real_t(input.a), real_t(input.b), real_t(input.c));
+        sink += static_cast<double>(convert<To>(from).l);
+      }
+    }
+  });
+  const double chain_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      for (const Triplet& input : inputs) {
+        const From from(real_t(input.a), real_t(input.b), real_t(input.c));
+        sink += static_cast<double>(To(from.get_rgb()).l);
+      }
+    }
+  });
+  const double conversions = double(repeats) * inputs.size();
+  result.graph_ns = graph_s * 1e9 / conversions;
+  result.chain_ns = chain_s * 1e9 / conversions;
+
+  // keep the timed loops from being optimized out
+  if (sink == 1.0) printf(" ");
+  return result;
+}
+
+static void print(const char* name, const size_t count, const Result& r) {
+  printf("%-14s %6zu %12.5f %12.5f %10.1f %10.1f\n", name, count, r.graphError,
+         r.chainError, r.graph_ns, r.chain_ns);
+}
+
+int main() {
+  static const char* precisions[] = {"double", "float", "fixed"};
+  printf("precision: %s\n", precisions[COLORSPACE_PRECISION]);
+
+  // LCH and OKLCH grids, in gamut only: the chain clamps the others
+  std::vector<Triplet> lch, oklch;
+  for (int l = 10; l <= 90; l += 5) {
+    for (int c = 0; c <= 100; c += 5) {
+      for (int h = 0; h < 360; h += 5) {
+        const Triplet polar = {double(l), double(c), double(h)};
+        const Triplet linear = reference::xyz_to_linear(
+            reference::lab_to_xyz(reference::from_polar(polar)));
+        if (is_in_gamut(linear)) lch.push_back(polar);
+      }
+    }
+  }
+  for (int l = 10; l <= 90; l += 5) {
+    for (int c = 0; c <= 30; c += 2) {
+      for (int h = 0; h < 360; h += 5) {
+        const Triplet polar = {l / 100.0, c / 100.0, double(h)};
+        const Triplet linear =
+            reference::oklab_to_linear(reference::from_polar(polar));
+        if (is_in_gamut(linear)) oklch.push_back(polar);
+      }
+    }
+  }
+
+  printf("%-14s %6s %12s %12s %10s %10s\n", "conversion", "count",
+         "graph error", "chain error", "graph ns", "chain ns");
+
+  const Result toOklch = run<OKLCH, LCH>(lch, [](const Triplet& input) {
+    return reference::linear_to_oklab(reference::xyz_to_linear(
+        reference::lab_to_xyz(reference::from_polar(input))));
+  });
+  print("LCH -> OKLCH", lch.size(), toOklch);
+
+  const Result toLch = run<LCH, OKLCH>(oklch, [](const Triplet& input) {
+    return reference::xyz_to_lab(reference::linear_to_xyz(
+        reference::oklab_to_linear(reference::from_polar(input))));
+  });
+  print("OKLCH -> LCH", oklch.size(), toLch);
+
+  const bool isValid = toOklch.graphError <= toOklch.chainError and
+                       toLch.graphError <= toLch.chainError;
+  return isValid ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+// Simulate the led current limiter against a battery and load model:
+//     S=../src/system
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o current_limiter_sim current_limiter_sim.cpp host/pwm_mock.cpp
+//         $S/physical/led_power.cpp $S/utils/utils.cpp
+//     ./current_limiter_sim [trace.csv]
+// (the g++ command is on one line)
+// Model:
+// - 4S li-ion pack: open circuit voltage from 3.3V to 4.2V per cell, linear
+//   with the state of charge, and an internal resistance
+// - load: the led strip (12V) behind a 90% efficient driver, at the current
+//   played by the pwm mock, plus the rest of the system (constant power)
+// - charger telemetry: IDCHG truncated to its 256mA resolution, PSYS with a
+//   2% noise, both one sample late (the ADC runs in one shot mode)
+// Each scenario rests 10s with the leds off, then asks the full led current
+// for 30s. Reports the time for the real load to settle under the budget,
+// the limiter scale and the real load over the last 10s.
+// The optional trace is time_ms,scenario,scale,battery_mA,system_W.
+// Returns 1 if the real load does not settle under the budget.
+
+#include <cmath>
+#include <cstdio>
+
+#include "../src/system/physical/led_power.h"
+#include "../src/system/utils/constants.h"
+#include "host/pwm_mock.h"
+
+static constexpr uint32_t step_ms = 10;
+static constexpr uint32_t rest_ms = 10000;
+static constexpr uint32_t run_ms = 30000;
+static constexpr uint32_t window_ms = 10000;
+
+static constexpr float cellCount = 4;
+static constexpr float stripVoltage_V = 12.0;
+static constexpr float driverEfficiency = 0.9;
+static constexpr uint16_t idchgResolution_mA = 256;
+static constexpr float psysNoise = 0.02;
+
+struct Scenario {
+  const char* name;
+  float soc;                  // %
+  float resistance_Ohm;       // pack internal resistance
+  float systemPower_W;        // load of the rest of the system
+  float extraPower_W;         // added load, after extraPowerDelay_ms
+  uint32_t extraPowerDelay_ms;
+};
+
+static const Scenario scenarios[] = {
+    {"full battery", 100.0, 0.15, 1.0, 0.0, 0},
+    {"empty aged battery", 0.0, 0.6, 1.0, 0.0, 0},
+    {"extra system load", 50.0, 0.15, 1.0, 8.0, 10000},
+};
+
+// state of the model, updated at each step
+static float batteryCurrent_mA = 0;
+static float systemPower_W = 0;
+
+// one sample late, like the one shot ADC of the charger
+static uint16_t lastIdchg_mA = 0;
+static float lastPsys_W = 0;
+
+// deterministic noise, from -1 to 1
+static float get_noise() {
+  static uint32_t state = 12345;
+  state = state * 1664525u + 1013904223u;
+  return (state >> 8) / float(1 << 23) - 1.0;
+}
+
+namespace charger {
+
+bool get_discharge_measures(uint16_t& dischargeCurrent_mA,
+                            float& systemPower_W) {
+  dischargeCurrent_mA = lastIdchg_mA;
+  systemPower_W = lastPsys_W;
+
+  lastIdchg_mA = uint16_t(batteryCurrent_mA / idchgResolution_mA) *
+                 idchgResolution_mA;
+  lastPsys_W = ::systemPower_W * (1.0 + psysNoise * get_noise());
+  return true;
+}
+
+}  // namespace charger
+
+// solve the battery current for a load power: P = (Vocv - R.I).I
+static void update_model(const Scenario& scenario, const uint32_t runTime_ms) {
+  const float ledCurrent_A =
+      pwm::mock::get_duty_cycle() * maxPowerConsumption_A;
+  float power_W = ledCurrent_A * stripVoltage_V / driverEfficiency +
+                  scenario.systemPower_W;
+  if (scenario.extraPower_W > 0 and runTime_ms >= scenario.extraPowerDelay_ms)
+    power_W += scenario.extraPower_W;
+
+  const float openCircuit_V = cellCount * (3.3 + 0.9 * scenario.soc / 100.0);
+  const float r = scenario.resistance_Ohm;
+  const float current_A =
+      (openCircuit_V -
+       sqrtf(openCircuit_V * openCircuit_V - 4.0 * r * power_W)) /
+      (2.0 * r);
+
+  batteryCurrent_mA = current_A * 1000.0;
+  systemPower_W = power_W;
+}
+
+// ratio of the power budget in use, from the real values
+static float get_real_load() {
+  return fmax(batteryCurrent_mA / maxDischargeCurrent_mA,
+              systemPower_W / maxSystemPower_W);
+}
+
+int main(int argc, char** argv) {
+  FILE* trace = argc > 1 ? fopen(argv[1], "w") : nullptr;
+  if (trace != nullptr) {
+    fprintf(trace, "time_ms,scenario,scale,battery_mA,system_W\n");
+  }
+
+  printf("budget: %u mA, %.0f W\n", maxDischargeCurrent_mA, maxSystemPower_W);
+  printf("%-20s %10s %8s %8s %10s %10s\n", "scenario", "settle ms", "scale",
+         "swing", "load avg", "load max");
+
+  bool isValid = true;
+  uint8_t index = 0;
+  for (const Scenario& scenario : scenarios) {
+    ledpower::write_current(0.0);
+    for (uint32_t t = 0; t < rest_ms; t += step_ms) {
+      host::time_ms += step_ms;
+      update_model(scenario, 0);
+      ledpower::update_current_limiter();
+    }
+
+    ledpower::write_current(maxPowerConsumption_A);
+    // last time the real load was over the budget
+    uint32_t lastOverload_ms = 0;
+    float minScale = 1.0, maxScale = 0.0;
+    float loadSum = 0.0, maxLoad = 0.0;
+    uint32_t windowSteps = 0;
+    for (uint32_t t = 0; t < run_ms; t += step_ms) {
+      host::time_ms += step_ms;
+      update_model(scenario, t);
+      ledpower::update_current_limiter();
+
+      const float load = get_real_load();
+      if (load > 1.0) lastOverload_ms = t + step_ms;
+      if (t >= run_ms - window_ms) {
+        const float scale = ledpower::get_current_limiter_scale();
+        minScale = fmin(minScale, scale);
+        maxScale = fmax(maxScale, scale);
+        loadSum += load;
+        maxLoad = fmax(maxLoad, load);
+        windowSteps++;
+      }
+      if (trace != nullptr) {
+        fprintf(trace, "%u,%u,%.4f,%.0f,%.2f\n", host::time_ms, index,
+                ledpower::get_current_limiter_scale(), batteryCurrent_mA,
+                systemPower_W);
+      }
+    }
+
+    printf("%-20s %10u %8.3f %8.3f %9.1f%% %9.1f%%\n", scenario.name,
+           lastOverload_ms, ledpower::get_current_limiter_scale(),
+           maxScale - minScale, 100.0 * loadSum / windowSteps, 100.0 * maxLoad);
+    isValid = isValid and maxLoad <= 1.0;
+    index++;
+  }
+
+  if (trace != nullptr) fclose(trace);
+  return isValid ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+// Check the temporal dithering of 16 bits levels on 8 bits outputs:
+//     g++ -std=gnu++17 -O2 -o dither_test dither_test.cpp
+//     ./dither_test
+// For every 16 bits target, the average output over windows of 16, 64 and
+// 256 frames is compared to the exact level (target * 255 / 65535), next to
+// the error of the rounded 8 bits output (get_rounded, no dithering).
+// Also reports the cost of a frame.
+// Returns 1 if the average over 256 frames is more than 1/256 LSB away from
+// the target, or if the rounded output is more than 1/2 LSB away.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "../src/system/utils/dither.h"
+
+static constexpr uint32_t targetCount = UINT16_MAX + 1;
+static constexpr int windows[] = {16, 64, 256};
+static constexpr long timedFrames = 100000000;
+
+int main() {
+  double maxError[3] = {0.0, 0.0, 0.0};
+  double maxRoundingError = 0.0;
+  for (uint32_t target = 0; target < targetCount; target++) {
+    const double exact = target * 255.0 / UINT16_MAX;
+    utils::Dither8 rounded;
+    rounded.set_target(target);
+    maxRoundingError =
+        fmax(maxRoundingError, fabs(rounded.get_rounded() - exact));
+
+    for (int w = 0; w < 3; w++) {
+      utils::Dither8 dither;
+      dither.set_target(target);
+      uint32_t sum = 0;
+      for (int frame = 0; frame < windows[w]; frame++) {
+        sum += dither.next();
+      }
+      maxError[w] = fmax(maxError[w], fabs(double(sum) / windows[w] - exact));
+    }
+  }
+
+  printf("8 bits rounding: max error %.4f LSB\n", maxRoundingError);
+  for (int w = 0; w < 3; w++) {
+    printf("dither, average over %3d frames: max error %.4f LSB\n", windows[w],
+           maxError[w]);
+  }
+
+  // a slowly changing target, like a brightness ramp
+  utils::Dither8 dither;
+  volatile uint8_t sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (long frame = 0; frame < timedFrames; frame++) {
+    dither.set_target(frame >> 10);
+    sink += dither.next();
+  }
+  const double elapsed_ns = std::chrono::duration<double, std::nano>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+  printf("cost: %.2f ns per frame\n", elapsed_ns / timedFrames);
+
+  return maxError[2] <= 1.0 / 256.0 and maxRoundingError <= 0.5 ? 0 : 1;
+}
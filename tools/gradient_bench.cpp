@@ -0,0 +1,104 @@
+// Compare the cached OKLAB gradients to the per call paths:
+//     S=../src/system/utils
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o gradient_bench gradient_bench.cpp $S/utils.cpp
+//         $S/colorspace.cpp $S/linearization.cpp $S/fixed_point.cpp
+//     ./gradient_bench
+// (the g++ command is on one line)
+// For the battery (red to green, 64 steps) and breeze (black to blue, 32
+// steps) gradients, over the 65536 levels:
+// - time per lookup of the table, of utils::get_gradient (raw RGB blend, the
+//   previous path), and of ColorSpace::oklab_blend (computed on each call)
+// - largest channel error of the table against the per call OKLAB path
+// - the ends of the table must be the exact stops
+// The battery color is computed once by alert tick: it uses oklab_blend, the
+// table is only kept for the breeze frames.
+// Returns 1 if an end of a gradient is not its stop.
+
+#include <chrono>
+#include <cstdio>
+
+#include "../src/system/utils/gradient.h"
+
+using namespace utils::ColorSpace;
+
+static constexpr uint32_t levelCount = UINT16_MAX + 1;
+static constexpr int repeats = 20;
+
+template <typename Function> static double time_s(const Function& function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+static int channel_error(const COLOR& x, const COLOR& y) {
+  return max(max(abs(x.red - y.red), abs(x.green - y.green)),
+             abs(x.blue - y.blue));
+}
+
+// the same gradient, interpolated in OKLAB on every call
+static uint32_t get_oklab_gradient(const uint32_t start, const uint32_t end,
+                                   const float level) {
+  COLOR s, e;
+  s.color = start;
+  e.color = end;
+  return oklab_blend(s, e, level).color;
+}
+
+template <uint16_t steps>
+static bool run(const char* name, const uint32_t start, const uint32_t end) {
+  const utils::Gradient<steps> gradient({start, end});
+
+  uint32_t sink = 0;
+  const double table_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      for (uint32_t level = 0; level < levelCount; level++) {
+        sink += gradient.get_color16(level);
+      }
+    }
+  });
+  const double rgb_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      for (uint32_t level = 0; level < levelCount; level++) {
+        sink += utils::get_gradient(start, end, level / float(UINT16_MAX));
+      }
+    }
+  });
+  const double oklab_s = time_s([&]() {
+    for (int r = 0; r < repeats; r++) {
+      for (uint32_t level = 0; level < levelCount; level++) {
+        sink += get_oklab_gradient(start, end, level / float(UINT16_MAX));
+      }
+    }
+  });
+
+  int error = 0;
+  for (uint32_t level = 0; level < levelCount; level++) {
+    COLOR table, exact;
+    table.color = gradient.get_color16(level);
+    exact.color = get_oklab_gradient(start, end, level / float(UINT16_MAX));
+    error = max(error, channel_error(table, exact));
+  }
+  const bool areEndsExact = gradient.get_color16(0) == start and
+                            gradient.get_color16(UINT16_MAX) == end;
+
+  const double lookups = double(repeats) * levelCount;
+  printf("%-8s %10.1f %10.1f %10.1f %8d %6s\n", name, table_s * 1e9 / lookups,
+         rgb_s * 1e9 / lookups, oklab_s * 1e9 / lookups, error,
+         areEndsExact ? "yes" : "no");
+
+  // keep the timed loops from being optimized out
+  if (sink == 1) printf(" ");
+  return areEndsExact;
+}
+
+int main() {
+  printf("%-8s %10s %10s %10s %8s %6s\n", "gradient", "table ns", "rgb ns",
+         "oklab ns", "error", "ends");
+
+  bool isValid = run<64>("battery", RED.get_rgb().color, GREEN.get_rgb().color);
+  isValid &= run<32>("breeze", BLACK.get_rgb().color, BLUE.get_rgb().color);
+  return isValid ? 0 : 1;
+}
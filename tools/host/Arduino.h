@@ -0,0 +1,170 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino and FreeRTOS surface, to build the hardware independent
+// modules of the lamp on a host (see tools/README.md).
+// It is force included (-include host/Arduino.h) instead of defining ARDUINO,
+// so the modules keep their host fallbacks (profiler clock for instance).
+// The time and the task calls are simulated: the tools drive them through
+// the host namespace.
+
+// the standard headers used by the tools are included before the min and max
+// macros
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace host {
+
+// simulated time, returned by millis() and micros()
+inline uint32_t time_ms = 0;
+
+// handle returned by xTaskGetCurrentTaskHandle()
+inline void* currentTask = nullptr;
+
+// last task notified (xTaskNotifyGive and vTaskNotifyGiveFromISR)
+inline void* notifiedTask = nullptr;
+inline uint32_t notifyCount = 0;
+
+// last timeout passed to ulTaskNotifyTake, in ticks
+inline uint32_t sleepTicks = 0;
+
+// returned by readCPUTemperature() (degrees)
+inline float cpuTemperature_c = 25.0;
+
+}  // namespace host
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+class String : public std::string {
+ public:
+  String(const char* s = "") : std::string(s) {}
+  String(const std::string& s) : std::string(s) {}
+};
+
+#define HEX 16
+#define DEC 10
+
+// the serial output goes to stdout
+class Print {
+ public:
+  void print(const char* s) { fputs(s, stdout); }
+  void print(const String& s) { fputs(s.c_str(), stdout); }
+  void print(const double v, const int digits = 2) {
+    printf("%.*f", digits, v);
+  }
+  void print(const long v, const int base = DEC) {
+    printf(base == HEX ? "%lx" : "%ld", v);
+  }
+  void print(const int v, const int base = DEC) { print(long(v), base); }
+  void print(const unsigned v, const int base = DEC) { print(long(v), base); }
+  void print(const unsigned long v, const int base = DEC) {
+    print(long(v), base);
+  }
+  template <typename T> void println(const T& v) {
+    print(v);
+    println();
+  }
+  template <typename T> void println(const T& v, const int format) {
+    print(v, format);
+    println();
+  }
+  void println() { putchar('\n'); }
+};
+
+class HostSerial : public Print {
+ public:
+  void begin(const int) {}
+  int available() { return 0; }
+  int read() { return -1; }
+};
+inline HostSerial Serial;
+
+inline uint32_t millis() { return host::time_ms; }
+inline uint32_t micros() { return host::time_ms * 1000; }
+inline void delay(const uint32_t ms) { host::time_ms += ms; }
+inline void delayMicroseconds(const uint32_t) {}
+
+inline long random(const long high) { return high > 0 ? rand() % high : 0; }
+inline long random(const long low, const long high) {
+  return low + random(high - low);
+}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+// pins used by constants.h
+enum { D4 = 4, D6 = 6, D7 = 7, D8 = 8, OUT_BRIGHTNESS = 30 };
+
+inline void pinMode(uint32_t, int) {}
+inline void digitalWrite(uint32_t, int) {}
+inline int digitalRead(uint32_t) { return 0; }
+inline int analogRead(uint32_t) { return 0; }
+inline void analogWrite(uint32_t, int) {}
+inline float readCPUTemperature() { return host::cpuTemperature_c; }
+
+// FreeRTOS
+typedef void* TaskHandle_t;
+typedef void* TimerHandle_t;
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+#define pdFALSE 0
+#define pdTRUE 1
+#define configTICK_RATE_HZ 1024
+#define portMAX_DELAY 0xffffffffu
+#define portYIELD_FROM_ISR(x) (void)(x)
+#define TASK_PRIO_LOWEST 0
+#define TASK_PRIO_LOW 1
+#define TASK_PRIO_NORMAL 2
+#define TASK_PRIO_HIGH 3
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return host::currentTask; }
+inline void vTaskPrioritySet(TaskHandle_t, uint32_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t ticks) {
+  host::sleepTicks = ticks;
+  return 0;
+}
+inline void xTaskNotifyGive(TaskHandle_t task) {
+  host::notifiedTask = task;
+  host::notifyCount++;
+}
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t*) {
+  xTaskNotifyGive(task);
+}
+
+// software timers never fire on the host: the tools call the callbacks
+class SoftwareTimer {
+ public:
+  void begin(uint32_t, void (*)(TimerHandle_t), void* = nullptr, bool = true) {
+  }
+  void start() {}
+  void stop() {}
+  void setPeriod(uint32_t) {}
+};
+
+#endif
@@ -0,0 +1,24 @@
+#include "pwm_mock.h"
+
+namespace pwm {
+
+namespace mock {
+
+std::vector<uint16_t> compareValues;
+
+uint16_t get_compare_value() {
+  return compareValues.empty() ? 0 : compareValues.back();
+}
+
+float get_duty_cycle() {
+  return get_compare_value() / float((1 << brightnessResolution) - 1);
+}
+
+}  // namespace mock
+
+void write_brightness(const uint16_t duty) {
+  // same truncation as the peripheral configuration of pwm.cpp
+  mock::compareValues.push_back(duty >> (16 - brightnessResolution));
+}
+
+}  // namespace pwm
@@ -0,0 +1,25 @@
+#ifndef PWM_MOCK_H
+#define PWM_MOCK_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../../src/system/physical/pwm.h"
+
+/// Host implementation of src/system/physical/pwm.h: link host/pwm_mock.cpp
+/// instead of pwm.cpp, the duty cycles are recorded instead of played.
+namespace pwm::mock {
+
+// compare values loaded in the PWM sequence, in write order
+// (pwm::brightnessResolution bits, like the peripheral)
+extern std::vector<uint16_t> compareValues;
+
+// last compare value, 0 before the first write
+uint16_t get_compare_value();
+
+// duty cycle of the last write, from 0 to 1
+float get_duty_cycle();
+
+}  // namespace pwm::mock
+
+#endif
@@ -0,0 +1,141 @@
+// Compare the integer hue helpers to the float HSV path they replaced:
+//     S=../src/system/utils
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o hue_bench hue_bench.cpp $S/utils.cpp
+//         $S/colorspace.cpp $S/linearization.cpp $S/fixed_point.cpp
+//     ./hue_bench
+// (the g++ command is on one line)
+// The previous implementations are kept below (namespace previous), on the
+// 360 entries table of hue_to_rgb_sinus (kept: the 64 entries hsv16_to_rgb
+// took 14.9ns against 5.4ns by call, and differed by up to 2). Reports:
+// - the largest difference between get_hue16 and the float HSV hue, over all
+//   the 2^24 RGB colors (1/65536 of a turn)
+// - the largest channel difference between the new and previous outputs of
+//   get_complementary_color and get_random_complementary_color (same random
+//   sequence)
+// - the time per call of both versions
+
+#include <chrono>
+#include <cstdio>
+
+#include "../src/system/utils/colorspace.h"
+#include "../src/system/utils/utils.h"
+
+static constexpr uint32_t colorCount = 1 << 24;
+static constexpr uint32_t timedCalls = 2000000;
+static constexpr float tolerance = 0.2;
+
+namespace previous {
+
+uint32_t get_complementary_color(const uint32_t color) {
+  COLOR c;
+  c.color = color;
+  const uint16_t hue = utils::ColorSpace::HSV(c).get_scaled_hue();
+
+  const uint16_t finalHue = (uint32_t)(hue + UINT16_MAX / 2.0) % UINT16_MAX;
+  return utils::hue_to_rgb_sinus(map(finalHue, 0, UINT16_MAX, 0, 360));
+}
+
+uint32_t get_random_complementary_color(const uint32_t color,
+                                        const float tolerance) {
+  COLOR c;
+  c.color = color;
+  const float hue = static_cast<float>(utils::ColorSpace::HSV(c).h);
+
+  const float comp =
+      360.0 * (0.1 + utils::map(rand(), 0, RAND_MAX, -tolerance / 2.0,
+                                tolerance / 2.0));
+
+  const uint16_t finalHue = fmod(hue + 360.0 / 2.0 + comp, 360.0f);
+  return utils::hue_to_rgb_sinus(finalHue);
+}
+
+}  // namespace previous
+
+static int channel_error(const uint32_t x, const uint32_t y) {
+  COLOR a, b;
+  a.color = x;
+  b.color = y;
+  return max(max(abs(a.red - b.red), abs(a.green - b.green)),
+             abs(a.blue - b.blue));
+}
+
+// spread the colors with a multiplicative hash
+static uint32_t get_color(const uint32_t i) {
+  return (i * 2654435761u) & 0xFFFFFF;
+}
+
+template <typename Function> static double time_ns(const Function& function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         timedCalls;
+}
+
+int main() {
+  // hue difference, wrapped around the turn
+  int hueError = 0;
+  for (uint32_t i = 0; i < colorCount; i++) {
+    COLOR c;
+    c.color = i;
+    const double hsvHue =
+        static_cast<double>(utils::ColorSpace::HSV(c).h) * 65536.0 / 360.0;
+    double difference = fabs(utils::get_hue16(c) - hsvHue);
+    difference = fmin(difference, 65536.0 - difference);
+    const int error = ceil(difference);
+    hueError = max(hueError, error);
+  }
+  printf("get_hue16 against the HSV hue: %d / 65536 of a turn\n", hueError);
+
+  // max is a macro: the errors are computed before, so the random sequence
+  // is only consumed once
+  int complementaryError = 0;
+  int randomError = 0;
+  for (uint32_t i = 0; i < timedCalls; i++) {
+    const uint32_t color = get_color(i);
+    const int error = channel_error(utils::get_complementary_color(color),
+                                    previous::get_complementary_color(color));
+    complementaryError = max(complementaryError, error);
+
+    srand(i);
+    const uint32_t random =
+        utils::get_random_complementary_color(color, tolerance);
+    srand(i);
+    const uint32_t previousRandom =
+        previous::get_random_complementary_color(color, tolerance);
+    const int randomDifference = channel_error(random, previousRandom);
+    randomError = max(randomError, randomDifference);
+  }
+  printf("channel difference with the previous outputs:\n");
+  printf("  get_complementary_color %d, get_random_complementary_color %d\n",
+         complementaryError, randomError);
+
+  uint32_t sink = 0;
+  printf("%-32s %10s %10s\n", "ns per call", "new", "previous");
+  printf("%-32s %10.1f %10.1f\n", "get_complementary_color",
+         time_ns([&sink]() {
+           for (uint32_t i = 0; i < timedCalls; i++)
+             sink += utils::get_complementary_color(get_color(i));
+         }),
+         time_ns([&sink]() {
+           for (uint32_t i = 0; i < timedCalls; i++)
+             sink += previous::get_complementary_color(get_color(i));
+         }));
+  printf("%-32s %10.1f %10.1f\n", "get_random_complementary_color",
+         time_ns([&sink]() {
+           for (uint32_t i = 0; i < timedCalls; i++)
+             sink += utils::get_random_complementary_color(get_color(i),
+                                                           tolerance);
+         }),
+         time_ns([&sink]() {
+           for (uint32_t i = 0; i < timedCalls; i++)
+             sink += previous::get_random_complementary_color(get_color(i),
+                                                              tolerance);
+         }));
+
+  // keep the timed loops from being optimized out
+  if (sink == 1) printf(" ");
+  return 0;
+}
@@ -0,0 +1,113 @@
+// Check the led driver outputs of ledpower, with the recording pwm mock:
+//     S=../src/system
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o led_power_test led_power_test.cpp host/pwm_mock.cpp
+//         $S/utils/utils.cpp
+//     ./led_power_test
+// (the g++ command is on one line)
+// Checks the current to duty cycle mapping: ends, clamping, monotony, error
+// against the exact duty cycle, one PWM write per call, and the brightness
+// scale of a test led strip.
+// The strip of user_constants.h is not set (no consumption), so the test
+// defines its own strip in place of user_constants.h, and builds led_power.cpp
+// with it (included below).
+// Returns 1 if a check fails.
+
+#include <cstdio>
+
+// test strip: 1m of 14.4W/m at 12V, 1.2A at full brightness
+#define USER_CONSTANTS
+const String SOFTWARE_VERSION = "test";
+constexpr float consWattByMeter = 14.4;
+constexpr float inputVoltage_V = 12;
+constexpr float ledStripLenght_mm = 1000;
+
+#include "../src/system/physical/led_power.cpp"
+#include "host/pwm_mock.h"
+
+namespace charger {
+
+// no charger telemetry: the current limiter keeps its scale
+bool get_discharge_measures(uint16_t&, float&) { return false; }
+
+}  // namespace charger
+
+static constexpr float maxCompareValue = (1 << pwm::brightnessResolution) - 1;
+static constexpr int currentSteps = 100000;
+
+static int failures = 0;
+
+static void check(const bool condition, const char* name) {
+  printf("%-48s %s\n", name, condition ? "ok" : "FAILED");
+  if (not condition) failures++;
+}
+
+// compare value for a current, without truncation
+static float get_exact_compare_value(const float current_A) {
+  return current_A / maxPowerConsumption_A * maxCompareValue;
+}
+
+int main() {
+  using pwm::mock::get_compare_value;
+
+  ledpower::write_current(0.0);
+  check(get_compare_value() == 0, "no current: PWM off");
+  ledpower::write_current(maxPowerConsumption_A);
+  check(get_compare_value() == maxCompareValue, "max current: PWM always on");
+  ledpower::write_current(2.0 * maxPowerConsumption_A);
+  check(get_compare_value() == maxCompareValue, "over current: clamped");
+  ledpower::write_current(-1.0);
+  check(get_compare_value() == 0, "negative current: clamped");
+
+  pwm::mock::compareValues.clear();
+  bool isMonotonic = true;
+  float maxError = 0.0;
+  uint16_t lastValue = 0;
+  for (int step = 0; step <= currentSteps; step++) {
+    const float current_A = maxPowerConsumption_A * step / currentSteps;
+    ledpower::write_current(current_A);
+
+    const uint16_t value = get_compare_value();
+    isMonotonic = isMonotonic and value >= lastValue;
+    lastValue = value;
+    maxError = fmax(maxError, fabs(value - get_exact_compare_value(current_A)));
+  }
+  printf("current sweep: max error %.3f LSB (%d bits)\n", maxError,
+         pwm::brightnessResolution);
+  check(pwm::mock::compareValues.size() == currentSteps + 1,
+        "one PWM write per write_current");
+  check(isMonotonic, "duty cycle monotonic with the current");
+  check(maxError <= 1.0, "duty cycle within 1 LSB");
+  check(ledpower::get_output_current() == maxPowerConsumption_A,
+        "output current reported");
+
+  // brightness scale of the test strip
+  static_assert(maxStripConsumption_A > 0.0 and
+                    maxStripConsumption_A < maxPowerConsumption_A,
+                "the test strip must use a part of the driver range");
+  ledpower::write_brightness16(UINT16_MAX);
+  const uint16_t fullBrightness = get_compare_value();
+  printf("full brightness: %.3f A, compare value %u\n", maxStripConsumption_A,
+         fullBrightness);
+  check(fabs(fullBrightness - get_exact_compare_value(maxStripConsumption_A)) <=
+            1.0,
+        "full brightness is maxStripConsumption_A");
+
+  bool areStepsExact = true;
+  bool do8And16BitsMatch = true;
+  for (const uint8_t brightness : {0, 1, 64, 128, 192, 254, 255}) {
+    const float current_A = maxStripConsumption_A * brightness / 255.0;
+    ledpower::write_brightness16(brightness * 257);
+    const uint16_t value = get_compare_value();
+    ledpower::write_brightness(brightness);
+    do8And16BitsMatch = do8And16BitsMatch and get_compare_value() == value;
+    areStepsExact = areStepsExact and
+                    fabs(value - get_exact_compare_value(current_A)) <= 1.0;
+    printf("  brightness %3u: compare value %5u, exact %8.1f\n", brightness,
+           value, get_exact_compare_value(current_A));
+  }
+  check(areStepsExact, "brightness steps within 1 LSB");
+  check(do8And16BitsMatch, "8 and 16 bits brightness match");
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// Check the sRGB transfer tables over all the 2^24 RGB colors, and compare
+// their speed to the pow transfer functions they replaced:
+//     S=../src/system/utils
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o linearization_test linearization_test.cpp
+//         $S/colorspace.cpp $S/linearization.cpp $S/fixed_point.cpp
+//     ./linearization_test
+// (the g++ command is on one line, add -DCOLORSPACE_PRECISION=0 or 2 to test
+// the other precisions)
+// Reports, for every RGB input:
+// - the channel round trip through the tables (must be exact)
+// - the largest error of the RGB -> XYZ -> RGB and RGB -> LAB -> RGB round
+//   trips
+// - the time of the XYZ round trip through the tables and through pow
+// Returns 1 if a channel round trip through the tables is not exact.
+
+#include <chrono>
+#include <cstdio>
+
+#include "../src/system/utils/colorspace.h"
+#include "../src/system/utils/linearization.h"
+#include "color_reference.h"
+
+using namespace utils::ColorSpace;
+
+static constexpr uint32_t colorCount = 1 << 24;
+
+static COLOR get_color(const uint32_t i) {
+  COLOR c;
+  c.color = i;
+  c.white = 0;
+  return c;
+}
+
+static int channel_error(const COLOR& x, const COLOR& y) {
+  return max(max(abs(x.red - y.red), abs(x.green - y.green)),
+             abs(x.blue - y.blue));
+}
+
+// RGB -> XYZ -> RGB with the pow transfer functions, like before the tables
+static COLOR pow_xyz_round_trip(const COLOR& c) {
+  const reference::Triplet xyz = reference::rgb_to_xyz(c.red, c.green, c.blue);
+  const double x = xyz.a / 100.0;
+  const double y = xyz.b / 100.0;
+  const double z = xyz.c / 100.0;
+  COLOR out;
+  out.white = 0;
+  out.red = reference::to_channel(3.2404542 * x - 1.5371385 * y -
+                                  0.4985314 * z);
+  out.green = reference::to_channel(-0.9692660 * x + 1.8760108 * y +
+                                    0.0415560 * z);
+  out.blue = reference::to_channel(0.0556434 * x - 0.2040259 * y +
+                                   1.0572252 * z);
+  return out;
+}
+
+template <typename Function> static double time_s(const Function& function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+int main() {
+  static const char* precisions[] = {"double", "float", "fixed"};
+  printf("precision: %s\n", precisions[COLORSPACE_PRECISION]);
+
+  int channelErrors = 0;
+  for (int channel = 0; channel < 256; channel++) {
+    if (from_linear(to_linear(channel)) != channel) channelErrors++;
+  }
+  printf("channel round trip: %d errors\n", channelErrors);
+
+  int xyzError = 0;
+  int labError = 0;
+  int powXyzError = 0;
+  for (uint32_t i = 0; i < colorCount; i++) {
+    const COLOR c = get_color(i);
+    xyzError = max(xyzError, channel_error(XYZ(c).get_rgb(), c));
+    labError = max(labError, channel_error(LAB(c).get_rgb(), c));
+    powXyzError = max(powXyzError, channel_error(pow_xyz_round_trip(c), c));
+  }
+  printf("round trip over %u colors: XYZ %d LSB, LAB %d LSB (pow XYZ %d LSB)\n",
+         colorCount, xyzError, labError, powXyzError);
+
+  uint32_t sink = 0;
+  const double table_s = time_s([&sink]() {
+    for (uint32_t i = 0; i < colorCount; i++) {
+      sink += XYZ(get_color(i)).get_rgb().color;
+    }
+  });
+  const double pow_s = time_s([&sink]() {
+    for (uint32_t i = 0; i < colorCount; i++) {
+      sink += pow_xyz_round_trip(get_color(i)).color;
+    }
+  });
+  printf("XYZ round trips per second: tables %.0f, pow %.0f (x%.2f)\n",
+         colorCount / table_s, colorCount / pow_s, pow_s / table_s);
+
+  // keep the timed loops from being optimized out
+  if (sink == 1) printf(" ");
+  return channelErrors == 0 ? 0 : 1;
+}
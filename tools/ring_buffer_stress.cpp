@@ -0,0 +1,139 @@
+// Stress the lock free ring buffer with a producer and a consumer thread:
+//     g++ -std=gnu++17 -O2 -pthread -o ring_buffer_stress
+//         ring_buffer_stress.cpp
+//     ./ring_buffer_stress
+// (the g++ command is on one line, add -fsanitize=thread to also check the
+// memory orders)
+// The producer pushes numbered events, the consumer pops them, on buffers of
+// 4 and 16 elements (the sizes of the firmware), in two modes:
+// - lossless: the producer retries when the buffer is full, every event must
+//   arrive once, in order
+// - overflow: the producer drops the event when the buffer is full, like the
+//   interrupts do, and yields every few events (bursts of interrupts). The
+//   events that arrive must be the accepted ones, in order, and the dropped
+//   count must match the refused pushes
+// The events are filled in place (begin_push/end_push) and read in place
+// (front/pop_front), with redundant fields to detect a torn event.
+// Returns 1 if an event is lost, duplicated, reordered or torn.
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include "../src/system/utils/ring_buffer.h"
+
+static constexpr uint32_t eventCount = 2000000;
+// overflow mode: events by burst of the producer, longer than the buffers
+static constexpr uint32_t burstLength = 24;
+
+struct Event {
+  uint32_t sequence;
+  uint32_t inverted;  // ~sequence
+  uint32_t payload[4];
+};
+
+static Event make_event(const uint32_t sequence) {
+  Event event;
+  event.sequence = sequence;
+  event.inverted = ~sequence;
+  for (uint32_t i = 0; i < 4; ++i) event.payload[i] = sequence * (i + 3);
+  return event;
+}
+
+static bool is_intact(const Event& event) {
+  if (event.inverted != ~event.sequence) return false;
+  for (uint32_t i = 0; i < 4; ++i) {
+    if (event.payload[i] != event.sequence * (i + 3)) return false;
+  }
+  return true;
+}
+
+struct Result {
+  uint32_t accepted = 0;  // pushes that returned a slot
+  uint32_t refused = 0;   // pushes on a full buffer
+  uint32_t received = 0;
+  uint32_t errors = 0;   // lost, duplicated, reordered or torn events
+  uint32_t dropped = 0;  // get_dropped_count
+};
+
+template <uint16_t capacity>
+static Result run(const bool isLossless) {
+  utils::RingBuffer<Event, capacity> buffer;
+  std::atomic<bool> isProducerDone(false);
+  Result result;
+
+  std::thread producer([&]() {
+    for (uint32_t sequence = 0; sequence < eventCount; ++sequence) {
+      if (not isLossless and sequence % burstLength == 0) {
+        std::this_thread::yield();
+      }
+
+      Event* slot = buffer.begin_push();
+      while (slot == nullptr) {
+        result.refused++;
+        if (not isLossless) break;
+        std::this_thread::yield();
+        slot = buffer.begin_push();
+      }
+      if (slot == nullptr) continue;
+
+      *slot = make_event(sequence);
+      buffer.end_push();
+      result.accepted++;
+    }
+    isProducerDone.store(true, std::memory_order_release);
+  });
+
+  std::thread consumer([&]() {
+    int64_t last = -1;
+    while (true) {
+      const Event* event = buffer.front();
+      if (event == nullptr) {
+        // the last events may be published after the done flag is read
+        if (isProducerDone.load(std::memory_order_acquire) and
+            buffer.is_empty())
+          break;
+        std::this_thread::yield();
+        continue;
+      }
+
+      const bool isNext = isLossless ? event->sequence == last + 1
+                                     : event->sequence > last;
+      if (not is_intact(*event) or not isNext) result.errors++;
+      last = event->sequence;
+      buffer.pop_front();
+      result.received++;
+    }
+  });
+
+  producer.join();
+  consumer.join();
+  result.dropped = buffer.get_dropped_count();
+  return result;
+}
+
+template <uint16_t capacity>
+static bool check(const bool isLossless) {
+  const Result r = run<capacity>(isLossless);
+  bool isValid = r.errors == 0 and r.received == r.accepted and
+                 r.dropped == r.refused;
+  if (isLossless) isValid = isValid and r.accepted == eventCount;
+
+  printf("%-9s %8u %10u %10u %10u %8u %s\n",
+         isLossless ? "lossless" : "overflow", capacity, r.accepted,
+         r.received, r.dropped, r.errors, isValid ? "ok" : "FAILED");
+  return isValid;
+}
+
+int main() {
+  printf("%u events by run\n", eventCount);
+  printf("%-9s %8s %10s %10s %10s %8s\n", "mode", "capacity", "accepted",
+         "received", "dropped", "errors");
+
+  bool isValid = true;
+  isValid = check<4>(true) and isValid;
+  isValid = check<16>(true) and isValid;
+  isValid = check<4>(false) and isValid;
+  isValid = check<16>(false) and isValid;
+  return isValid ? 0 : 1;
+}
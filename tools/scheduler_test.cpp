@@ -0,0 +1,200 @@
+// Check the deadline scheduler of the firmware threads, with the simulated
+// time and task calls of host/Arduino.h:
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o scheduler_test scheduler_test.cpp ../src/system/scheduler.cpp
+//     ./scheduler_test
+// (the g++ command is on one line)
+// Checks the task ownership (a thread never waits for the tasks of another
+// thread, or of no thread: the boot spin of the loop thread), the deadline
+// order of a simulated thread, the millis overflow, the disabled tasks, the
+// wake up requests and the sleep durations.
+// Returns 1 if a check fails.
+
+#include <cstdio>
+#include <vector>
+
+#include "../src/system/scheduler.h"
+
+using scheduler::Task;
+
+// task handles of the simulated threads
+static int loopThread, inputThread, powerThread;
+
+static int failures = 0;
+
+static void check(const bool condition, const char* name) {
+  printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+  if (not condition) failures++;
+}
+
+static void run_in(int& thread) { host::currentTask = &thread; }
+
+// claim tasks in a thread, like the threads of the sketch do at start
+static void claim(int& thread, const std::vector<Task>& tasks) {
+  run_in(thread);
+  for (const Task task : tasks) scheduler::set_thread(task);
+}
+
+static void reset(const uint32_t time) {
+  host::time_ms = time;
+  host::notifiedTask = nullptr;
+  host::notifyCount = 0;
+  run_in(loopThread);
+  scheduler::setup();
+}
+
+static void check_boot() {
+  reset(1000);
+  // every task is due, but no thread claimed them yet
+  run_in(loopThread);
+  check(scheduler::time_to_next_deadline(host::time_ms) ==
+            scheduler::maxSleep_ms,
+        "boot: unclaimed tasks do not keep a thread awake");
+
+  // the sketch: the loop claims its tasks before starting the threads
+  claim(loopThread, {Task::DISPLAY, Task::USER});
+  check(scheduler::time_to_next_deadline(host::time_ms) == 0,
+        "boot: claimed tasks are due immediately");
+  check(scheduler::is_due(Task::DISPLAY, host::time_ms) and
+            scheduler::is_due(Task::USER, host::time_ms),
+        "boot: the loop runs its tasks");
+  scheduler::schedule_in(Task::DISPLAY, 20);
+  scheduler::schedule_in(Task::USER, 10);
+
+  // the other threads did not run yet: their due tasks must not make the
+  // loop spin (higher priority, it would starve them)
+  check(scheduler::time_to_next_deadline(host::time_ms) == 10,
+        "boot: the loop sleeps before the other threads run");
+
+  // a wake up before the owner starts: no notification, kept pending
+  scheduler::wake_from_isr(Task::BUTTON);
+  check(host::notifyCount == 0, "boot: no notification of an unclaimed task");
+  claim(inputThread, {Task::BUTTON});
+  check(scheduler::time_to_next_deadline(host::time_ms) == 0 and
+            scheduler::is_due(Task::BUTTON, host::time_ms),
+        "boot: the owner runs the pending request");
+}
+
+static void check_ownership() {
+  reset(1000);
+  claim(loopThread, {Task::DISPLAY, Task::USER});
+  claim(inputThread, {Task::BUTTON});
+  claim(powerThread, {Task::ALERTS, Task::BATTERY});
+  scheduler::set_deadline(Task::DISPLAY, 1050);
+  scheduler::set_deadline(Task::USER, 1040);
+  scheduler::set_deadline(Task::BUTTON, 1030);
+  scheduler::set_deadline(Task::ALERTS, 1020);
+  scheduler::set_deadline(Task::BATTERY, 1200);
+
+  run_in(loopThread);
+  const uint32_t loopSleep = scheduler::time_to_next_deadline(host::time_ms);
+  run_in(inputThread);
+  const uint32_t inputSleep = scheduler::time_to_next_deadline(host::time_ms);
+  run_in(powerThread);
+  const uint32_t powerSleep = scheduler::time_to_next_deadline(host::time_ms);
+  check(loopSleep == 40 and inputSleep == 30 and powerSleep == 20,
+        "each thread waits for its own earliest deadline");
+
+  scheduler::wake(Task::BATTERY);
+  check(host::notifiedTask == &powerThread,
+        "a wake up notifies the owner thread");
+  run_in(loopThread);
+  check(scheduler::time_to_next_deadline(host::time_ms) == 40,
+        "a wake up does not wake the other threads");
+}
+
+// run a thread with tasks of different periods for a while, and check that
+// the tasks run in deadline order, at their deadline
+static void check_deadline_order(const uint32_t startTime, const char* name) {
+  static const Task tasks[] = {Task::BUTTON, Task::DISPLAY, Task::USER};
+  static const uint32_t periods[] = {7, 11, 13};
+
+  reset(startTime);
+  claim(loopThread, {Task::BUTTON, Task::DISPLAY, Task::USER});
+  for (uint8_t i = 0; i < 3; ++i) {
+    scheduler::set_deadline(tasks[i], startTime + periods[i]);
+  }
+  uint32_t expected[3] = {startTime + periods[0], startTime + periods[1],
+                          startTime + periods[2]};
+
+  bool isOrdered = true;
+  uint32_t runs = 0;
+  for (int step = 0; step < 1000; ++step) {
+    const uint32_t sleep = scheduler::time_to_next_deadline(host::time_ms);
+    // the sleep ends on the earliest expected deadline
+    uint32_t earliest = scheduler::maxSleep_ms;
+    for (uint8_t i = 0; i < 3; ++i) {
+      earliest = min(earliest, uint32_t(expected[i] - host::time_ms));
+    }
+    isOrdered = isOrdered and sleep == earliest;
+    host::time_ms += sleep;
+
+    for (uint8_t i = 0; i < 3; ++i) {
+      const bool isDue = scheduler::is_due(tasks[i], host::time_ms);
+      isOrdered = isOrdered and isDue == (expected[i] == host::time_ms);
+      if (not isDue) continue;
+
+      scheduler::set_deadline(tasks[i], host::time_ms + periods[i]);
+      expected[i] = host::time_ms + periods[i];
+      runs++;
+    }
+  }
+  char label[64];
+  snprintf(label, sizeof(label), "deadline order and sleeps (%s)", name);
+  check(isOrdered and runs > 1000, label);
+}
+
+static void check_disabled() {
+  reset(1000);
+  claim(loopThread, {Task::USER, Task::DISPLAY});
+  scheduler::set_deadline(Task::DISPLAY, 1100);
+  scheduler::set_enabled(Task::USER, false);
+  check(not scheduler::is_due(Task::USER, host::time_ms),
+        "a disabled task is never due");
+  check(scheduler::time_to_next_deadline(host::time_ms) == 100,
+        "a disabled task does not keep its thread awake");
+  scheduler::wake(Task::USER);
+  check(not scheduler::is_due(Task::USER, host::time_ms),
+        "a disabled task ignores the wake up requests");
+
+  // disabled for a long time: the old deadline is far in the past
+  host::time_ms += 100000;
+  scheduler::set_enabled(Task::USER, true);
+  check(scheduler::is_due(Task::USER, host::time_ms),
+        "a newly enabled task is due immediately");
+}
+
+static void check_sleep() {
+  reset(1000);
+  claim(loopThread, {Task::USER});
+  scheduler::set_deadline(Task::USER, 1000 + 10 * scheduler::maxSleep_ms);
+  check(scheduler::time_to_next_deadline(host::time_ms) ==
+            scheduler::maxSleep_ms,
+        "sleeps are capped to maxSleep_ms");
+
+  scheduler::set_deadline(Task::USER, 1010);
+  const uint32_t wakeups = scheduler::get_wakeup_count();
+  scheduler::sleep_until_next_deadline();
+  // 10ms at 1024 ticks by second, rounded up
+  check(host::sleepTicks == 11, "sleep duration rounded up to the next tick");
+  check(scheduler::get_wakeup_count() == wakeups + 1, "wake ups are counted");
+
+  host::sleepTicks = 0;
+  scheduler::wake_from_isr(Task::USER);
+  scheduler::sleep_until_next_deadline();
+  check(host::sleepTicks == 0, "no sleep with a pending wake up request");
+  check(scheduler::is_due(Task::USER, host::time_ms) and
+            not scheduler::is_due(Task::USER, host::time_ms),
+        "a wake up request is consumed by is_due");
+}
+
+int main() {
+  check_boot();
+  check_ownership();
+  check_deadline_order(1000, "start of time");
+  check_deadline_order(UINT32_MAX - 500, "millis overflow");
+  check_disabled();
+  check_sleep();
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// Replay logged battery measures through the state of charge estimator.
+//
+// Enable the logging with the "soclog" serial command, capture the serial
+// output to a file, then:
+//     g++ -O2 -o soc_replay soc_replay.cpp ../src/system/utils/soc.cpp
+//     ./soc_replay log.txt [capacity_mAh] [initial_soc] > replay.csv
+// Input lines are "soc:<time_ms>,<current_mA>,<voltage_V>" (the "soc:" prefix
+// is optional, the voltage is corrected by the load), the other lines are
+// ignored.
+// Output: time_ms,current_mA,voltage_V,soc,open_circuit_soc,resting
+//
+// Without a log, simulate full discharges at steady loads, with the discharge
+// current truncated to the 256mA steps of the charger ADC:
+//     ./soc_replay --undercount [capacity_mAh]
+// Output, by load: the current read by the ADC, the estimation when the pack
+// is at the critical level, and the real state of charge when the SOC alert
+// and the voltage floor (soc::cellCutoffVoltage_V) trip.
+// Returns 1 if no critical alert trips before the pack is empty.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../src/system/utils/soc.h"
+
+// battery critical alert (batteryCritical of constants.h)
+static constexpr float criticalSoc = 3.0;
+// resolution of the charger discharge current (IDCHG)
+static constexpr int32_t dischargeStep_mA = 256;
+
+// pack open circuit voltage at a state of charge (inverse of the table)
+static float get_open_circuit_voltage(const float soc) {
+  float low = 3.0 * soc::cellCount;
+  float high = 4.3 * soc::cellCount;
+  for (uint8_t i = 0; i < 32; ++i) {
+    const float middle = (low + high) / 2.0;
+    if (soc::get_open_circuit_soc(middle) < soc) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return high;
+}
+
+// discharge a full pack at a steady load, the estimator sees the truncated
+// current and the exact open circuit voltage
+static bool simulate_undercount(const float capacity_mAh,
+                                const float load_mA) {
+  const int32_t measured_mA =
+      static_cast<int32_t>(load_mA) / dischargeStep_mA * dischargeStep_mA;
+
+  soc::Estimator estimator(capacity_mAh);
+  float realSoc = 100.0;
+  estimator.restore(realSoc, get_open_circuit_voltage(realSoc));
+
+  float estimationAtCritical = NAN;
+  float socAlertAt = NAN;
+  float floorAt = NAN;
+  for (uint32_t time_ms = 1000; realSoc > 0.0; time_ms += 1000) {
+    realSoc -= load_mA / (36.0 * capacity_mAh);
+    const float voltage_V = get_open_circuit_voltage(fmaxf(realSoc, 0.0));
+    estimator.update(time_ms, -measured_mA, voltage_V);
+
+    if (std::isnan(estimationAtCritical) and realSoc <= criticalSoc) {
+      estimationAtCritical = estimator.get_soc();
+    }
+    if (std::isnan(socAlertAt) and estimator.get_soc() <= criticalSoc) {
+      socAlertAt = realSoc;
+    }
+    if (std::isnan(floorAt) and
+        voltage_V < soc::cellCutoffVoltage_V * soc::cellCount) {
+      floorAt = realSoc;
+    }
+  }
+
+  const bool isProtected = not std::isnan(socAlertAt) or
+                           not std::isnan(floorAt);
+  char socAlert[16] = "never";
+  if (not std::isnan(socAlertAt)) {
+    snprintf(socAlert, sizeof(socAlert), "%.1f", socAlertAt);
+  }
+  printf("%8.0f %8d %14.1f %14s %14.1f %s\n", load_mA, measured_mA,
+         estimationAtCritical, socAlert, floorAt,
+         isProtected ? "ok" : "FAILED");
+  return isProtected;
+}
+
+static int run_undercount(const float capacity_mAh) {
+  static const float loads_mA[] = {150, 300, 500, 700, 1000, 2000};
+
+  printf("%.0fmAh pack, discharge current by steps of %dmA\n", capacity_mAh,
+         dischargeStep_mA);
+  printf("%8s %8s %14s %14s %14s\n", "load", "read", "soc@critical",
+         "real@soc_alert", "real@floor");
+  bool isValid = true;
+  for (const float load_mA : loads_mA) {
+    isValid = simulate_undercount(capacity_mAh, load_mA) and isValid;
+  }
+  return isValid ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr,
+            "usage: %s log.txt [capacity_mAh] [initial_soc]\n"
+            "       %s --undercount [capacity_mAh]\n",
+            argv[0], argv[0]);
+    return 1;
+  }
+  if (strcmp(argv[1], "--undercount") == 0) {
+    return run_undercount(argc > 2 ? atof(argv[2]) : 2500.0);
+  }
+
+  FILE* log = fopen(argv[1], "r");
+  if (log == nullptr) {
+    perror(argv[1]);
+    return 1;
+  }
+  const float capacity_mAh = argc > 2 ? atof(argv[2]) : 2500.0;
+  const bool hasInitialSoc = argc > 3;
+  const float initialSoc = hasInitialSoc ? atof(argv[3]) : 0.0;
+
+  soc::Estimator estimator(capacity_mAh);
+
+  printf("time_ms,current_mA,voltage_V,soc,open_circuit_soc,resting\n");
+  char line[256];
+  unsigned lineCount = 0;
+  while (fgets(line, sizeof(line), log) != nullptr) {
+    const char* values = strstr(line, "soc:");
+    values = values != nullptr ? values + 4 : line;
+
+    unsigned long time_ms;
+    float current_mA, voltage_V;
+    if (sscanf(values, "%lu,%f,%f", &time_ms, &current_mA, &voltage_V) != 3)
+      continue;
+
+    if (lineCount++ == 0 and hasInitialSoc) {
+      estimator.restore(initialSoc, voltage_V);
+    }
+    estimator.update(time_ms, current_mA, voltage_V);
+
+    printf("%lu,%.0f,%.3f,%.2f,%.2f,%d\n", time_ms, current_mA, voltage_V,
+           estimator.get_soc(), soc::get_open_circuit_soc(voltage_V),
+           estimator.is_resting() ? 1 : 0);
+  }
+  fclose(log);
+
+  fprintf(stderr, "%u measures replayed\n", lineCount);
+  return 0;
+}
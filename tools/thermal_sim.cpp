@@ -0,0 +1,232 @@
+// Simulate the thermal derating controller against a thermal model of the
+// lamp, to check its gains:
+//     g++ -std=gnu++17 -O2 -I host -include host/Arduino.h
+//         -o thermal_sim thermal_sim.cpp ../src/system/thermal.cpp
+//     ./thermal_sim [trace.csv]
+// (the g++ command is on one line)
+// Plant: first order model of the lamp body, heated by the leds at the
+// brightness allowed by the controller (the user asks the max brightness):
+//     steady temperature = ambient + rise at full output * output ratio
+// and sensed by the CPU die sensor (0.25 degree resolution).
+// The nominal plant (25C ambient, 60C rise at full output, 300s time
+// constant) runs through thermal.cpp itself. The gain sweep and the other
+// plants run a copy of its control law, checked against thermal.cpp first.
+// Reports the overshoot over the target, the settling time (within 1 degree
+// of the target), and the temperature and output swing over the last 10
+// minutes (oscillation).
+// The optional trace is time_s,temperature_c,output_ratio for the nominal
+// plant.
+// Returns 1 if, with the shipped gains, a plant of the lamp envelope reaches
+// the temperature alert (maxSystemTemp_c) or still oscillates. The bare strip
+// and strong heating plants are out of the envelope, and only reported.
+
+#include <cmath>
+#include <cstdio>
+
+#include "../src/system/thermal.h"
+#include "../src/system/utils/constants.h"
+
+namespace imu {
+
+// the IMU is off
+float get_temperature() { return NAN; }
+
+}  // namespace imu
+
+static constexpr uint32_t samplePeriod_ms = 1000;
+static constexpr uint32_t duration_s = 3 * 3600;
+static constexpr uint32_t window_s = 600;
+static constexpr float sensorResolution_c = 0.25;
+
+// gains and limits of thermal.cpp
+static constexpr float shippedKp = 0.05;
+static constexpr float shippedKi = 0.002;
+static constexpr float shippedMinOutput = 0.2;
+
+struct Plant {
+  const char* name;
+  float ambient_c;
+  float fullOutputRise_c;  // steady temperature rise at full output
+  float timeConstant_s;
+  bool isChecked;  // in the envelope of the lamp
+};
+
+static const Plant nominalPlant = {"nominal", 25.0, 60.0, 300.0, true};
+static const Plant plants[] = {
+    nominalPlant,
+    {"light body", 25.0, 60.0, 120.0, true},
+    {"bare strip", 25.0, 60.0, 60.0, false},
+    {"slow body", 25.0, 60.0, 900.0, true},
+    {"hot ambient", 35.0, 60.0, 300.0, true},
+    {"strong heating", 25.0, 100.0, 300.0, false},
+};
+
+// copy of the control law of thermal.cpp, with configurable gains
+class Controller {
+ public:
+  Controller(const float kp, const float ki, const float minOutput)
+      : _kp(kp), _ki(ki), _minOutput(minOutput) {}
+
+  void update(const float temperature) {
+    static constexpr float samplePeriod_s = samplePeriod_ms / 1000.0;
+    static constexpr float filterValue =
+        samplePeriod_s / (10.0 + samplePeriod_s);
+    if (std::isnan(_filtered)) {
+      _filtered = temperature;
+    } else {
+      _filtered += filterValue * (temperature - _filtered);
+    }
+
+    const float error = thermal::get_target_temperature() - _filtered;
+    const float newIntegral = _integral + _ki * error * samplePeriod_s;
+    const float output = 1.0 + _kp * error + newIntegral;
+    if (output > 1.0) {
+      _integral = fmin(0.0f, newIntegral);
+      _output = 1.0;
+    } else if (output < _minOutput) {
+      _output = _minOutput;
+    } else {
+      _integral = newIntegral;
+      _output = output;
+    }
+  }
+
+  float get_output() const { return _output; }
+
+ private:
+  float _kp, _ki, _minOutput;
+  float _filtered = NAN;
+  float _integral = 0.0;
+  float _output = 1.0;
+};
+
+struct Result {
+  float overshoot_c = 0.0;
+  uint32_t settle_s = 0;  // last time out of the target band
+  float temperatureSwing_c = 0.0;
+  float outputSwing = 0.0;
+  float finalTemperature_c = 0.0;
+  float finalOutput = 0.0;
+};
+
+static float sense(const float temperature) {
+  return roundf(temperature / sensorResolution_c) * sensorResolution_c;
+}
+
+// Run a plant from the ambient temperature. Controller returns the output
+// ratio for a sensed temperature, called once per sample period
+template <typename Control>
+static Result run(const Plant& plant, const Control& control,
+                  FILE* trace = nullptr) {
+  const float target = thermal::get_target_temperature();
+  const float decay =
+      expf(-(samplePeriod_ms / 1000.0) / plant.timeConstant_s);
+
+  Result result;
+  float temperature = plant.ambient_c;
+  float minTemperature = INFINITY, maxTemperature = -INFINITY;
+  float minOutput = INFINITY, maxOutput = -INFINITY;
+  for (uint32_t t = 0; t < duration_s; t++) {
+    const float output = control(sense(temperature));
+
+    // exact step of the first order plant, output held for the period
+    const float steady = plant.ambient_c + plant.fullOutputRise_c * output;
+    temperature = steady + (temperature - steady) * decay;
+
+    result.overshoot_c = fmax(result.overshoot_c, temperature - target);
+    if (fabs(temperature - target) > 1.0) result.settle_s = t + 1;
+    if (t >= duration_s - window_s) {
+      minTemperature = fmin(minTemperature, temperature);
+      maxTemperature = fmax(maxTemperature, temperature);
+      minOutput = fmin(minOutput, output);
+      maxOutput = fmax(maxOutput, output);
+    }
+    if (trace != nullptr) {
+      fprintf(trace, "%u,%.3f,%.4f\n", t, temperature, output);
+    }
+    result.finalOutput = output;
+  }
+  result.finalTemperature_c = temperature;
+  result.temperatureSwing_c = maxTemperature - minTemperature;
+  result.outputSwing = maxOutput - minOutput;
+  return result;
+}
+
+static void print(const char* name, const Result& r) {
+  printf("%-16s %9.2f %9u %9.2f %9.3f %9.2f %9.3f\n", name, r.overshoot_c,
+         r.settle_s, r.temperatureSwing_c, r.outputSwing, r.finalTemperature_c,
+         r.finalOutput);
+}
+
+static void print_header(const char* name) {
+  printf("%-16s %9s %9s %9s %9s %9s %9s\n", name, "overshoot", "settle s",
+         "T swing", "out swing", "final T", "final out");
+}
+
+static bool is_stable(const Result& r) {
+  return thermal::get_target_temperature() + r.overshoot_c < maxSystemTemp_c and
+         r.temperatureSwing_c <= 0.5;
+}
+
+int main(int argc, char** argv) {
+  FILE* trace = argc > 1 ? fopen(argv[1], "w") : nullptr;
+  if (trace != nullptr) fprintf(trace, "time_s,temperature_c,output_ratio\n");
+
+  printf("target %.1fC (alert at %.1fC)\n\n", thermal::get_target_temperature(),
+         maxSystemTemp_c);
+
+  // nominal plant through thermal.cpp, and through the copy of its law
+  host::time_ms = samplePeriod_ms;
+  const Result shipped = run(
+      nominalPlant,
+      [](const float temperature) {
+        host::cpuTemperature_c = temperature;
+        thermal::update();
+        host::time_ms += samplePeriod_ms;
+        return thermal::get_output_ratio();
+      },
+      trace);
+  Controller copy(shippedKp, shippedKi, shippedMinOutput);
+  const Result copied = run(nominalPlant, [&copy](const float temperature) {
+    copy.update(temperature);
+    return copy.get_output();
+  });
+  const bool isCopyExact =
+      shipped.finalTemperature_c == copied.finalTemperature_c and
+      shipped.settle_s == copied.settle_s;
+  printf("control law copy matches thermal.cpp: %s\n\n",
+         isCopyExact ? "yes" : "NO");
+
+  print_header("plant");
+  bool isValid = isCopyExact and is_stable(shipped);
+  print("thermal.cpp", shipped);
+  for (const Plant& plant : plants) {
+    Controller controller(shippedKp, shippedKi, shippedMinOutput);
+    const Result result = run(plant, [&controller](const float temperature) {
+      controller.update(temperature);
+      return controller.get_output();
+    });
+    print(plant.name, result);
+    if (plant.isChecked) isValid = isValid and is_stable(result);
+  }
+
+  // gains around the shipped ones, on the nominal plant
+  printf("\n");
+  print_header("kp / ki");
+  for (const float kp : {0.01f, 0.02f, 0.05f, 0.1f, 0.2f}) {
+    for (const float ki : {0.0005f, 0.002f, 0.008f}) {
+      Controller controller(kp, ki, shippedMinOutput);
+      const Result result =
+          run(nominalPlant, [&controller](const float temperature) {
+            controller.update(temperature);
+            return controller.get_output();
+          });
+      char name[32];
+      snprintf(name, sizeof(name), "%.2f / %.4f", kp, ki);
+      print(name, result);
+    }
+  }
+
+  if (trace != nullptr) fclose(trace);
+  return isValid ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Convert an event trace dump of the lamp to a Chrome trace timeline.
+
+Capture the output of the "trace" serial command to a file, then:
+    python3 trace_to_chrome.py dump.txt trace.json
+and open trace.json in chrome://tracing or https://ui.perfetto.dev
+"""
+
+import json
+import sys
+
+# keep in sync with tracer::Event (src/system/utils/tracer.h)
+# id: (name, track, phase), phase "B"/"E" opens/closes a duration event
+EVENTS = {
+    1: ("pd ic event", "pd", "i"),
+    2: ("pd protocol event", "pd", "i"),
+    3: ("pd power ready", "pd", "i"),
+    4: ("charger register write", "charger", "i"),
+    5: ("alert raised", "alerts", "i"),
+    6: ("alert cleared", "alerts", "i"),
+    7: ("file write", "file system", "B"),
+    8: ("file write", "file system", "E"),
+    9: ("fft", "microphone", "B"),
+    10: ("fft", "microphone", "E"),
+    11: ("loop overrun", "loop", "i"),
+}
+
+TRACKS = ["loop", "alerts", "charger", "pd", "file system", "microphone"]
+
+
+def decode_argument(event, argument):
+    """Human readable argument of an event"""
+    if event == 3:
+        status = argument >> 24
+        # PPS (status 2) units are 20mV and 50mA, fixed supplies 50mV and 10mA
+        is_pps = status == 2
+        names = ["none", "fixed", "pps"]
+        return {
+            "status": names[status] if status < len(names) else status,
+            "voltage_mV": ((argument >> 12) & 0xFFF) * (20 if is_pps else 50),
+            "current_mA": (argument & 0xFFF) * (50 if is_pps else 10),
+        }
+    if event == 4:
+        return {
+            "register": hex(argument >> 16),
+            "value": hex(argument & 0xFFFF),
+        }
+    if event in (1, 2, 5, 6):
+        return {"mask": hex(argument)}
+    if event == 11:
+        return {"runtime_ms": argument}
+    return {"argument": argument}
+
+
+def read_records(lines):
+    """Records of the last complete dump, as (time, event, argument)"""
+    records = None
+    dumps = []
+    for line in lines:
+        line = line.strip()
+        if line.startswith("trace begin"):
+            records = []
+        elif line.startswith("trace end"):
+            if records is not None:
+                dumps.append(records)
+            records = None
+        elif records is not None and line:
+            time, event, argument = (int(field, 16) for field in line.split())
+            records.append((time, event, argument))
+    if not dumps:
+        raise ValueError("no complete trace dump found")
+    return dumps[-1]
+
+
+def to_chrome_trace(records):
+    trace = []
+    for track in TRACKS:
+        trace.append({
+            "name": "thread_name",
+            "ph": "M",
+            "pid": 1,
+            "tid": TRACKS.index(track),
+            "args": {"name": track},
+        })
+
+    # unwrap the 32 bits micros timestamps. The records are in reservation
+    # order: an interrupt or a higher priority thread can trace between the
+    # time read and the reservation of a preempted writer, so the time may go
+    # back a little. Only a jump of more than 2^31 is a wrap
+    unwrapped = []
+    last_raw = None
+    last_time = 0
+    for time, event, argument in records:
+        if last_raw is not None:
+            delta = (time - last_raw) & 0xFFFFFFFF
+            if delta >= 1 << 31:
+                delta -= 1 << 32
+            last_time += delta
+        else:
+            last_time = time
+        last_raw = time
+        unwrapped.append((last_time, event, argument))
+    # stable: the records of the same time keep their order
+    unwrapped.sort(key=lambda record: record[0])
+
+    for time, event, argument in unwrapped:
+        name, track, phase = EVENTS.get(event,
+                                        ("event %d" % event, "loop", "i"))
+        entry = {
+            "name": name,
+            "ph": phase,
+            "ts": time,
+            "pid": 1,
+            "tid": TRACKS.index(track),
+            "args": decode_argument(event, argument),
+        }
+        if phase == "i":
+            entry["s"] = "t"
+        trace.append(entry)
+    return {"traceEvents": trace, "displayTimeUnit": "ms"}
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 1
+
+    with open(sys.argv[1], encoding="utf-8", errors="replace") as dump:
+        records = read_records(dump)
+    with open(sys.argv[2], "w", encoding="utf-8") as output:
+        json.dump(to_chrome_trace(records), output, indent=1)
+    print("%d records converted" % len(records))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())